@@ -0,0 +1,256 @@
+/*
+  Arduino.cpp - Arduino core stand-in for the native build
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Arduino.h"
+#include "NativeHal.h"
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unistd.h>
+#include <x86intrin.h>
+
+HardwareSerial Serial;
+HardwareSerial Serial1;
+EspClass ESP;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+static std::mutex pinLock;
+static std::map<uint8_t, uint8_t> pinLevels;
+static std::map<uint8_t, void (*)(void)> pinHandlers;
+static std::map<uint8_t, SpiDevice*> spiDevices;
+static SpiDevice* selected = nullptr;
+static uint32_t cpuFrequency = 240;
+
+unsigned long millis()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+unsigned long micros()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+void delay(uint32_t ms)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void delayMicroseconds(uint32_t us)
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(us));
+}
+
+void yield()
+{
+  std::this_thread::yield();
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {}
+
+void digitalWrite(uint8_t pin, uint8_t value)
+{
+  SpiDevice* device = nullptr;
+  bool select = false;
+  {
+    std::lock_guard<std::mutex> lock(pinLock);
+    pinLevels[pin] = value;
+    auto it = spiDevices.find(pin);
+    if (it != spiDevices.end())
+    {
+      device = it->second;
+      select = value == LOW;
+      selected = select ? device : nullptr;
+    }
+  }
+  if (device && select)
+    device->select();
+  else if (device)
+    device->deselect();
+}
+
+int digitalRead(uint8_t pin)
+{
+  std::lock_guard<std::mutex> lock(pinLock);
+  auto it = pinLevels.find(pin);
+  return it == pinLevels.end() ? LOW : it->second;
+}
+
+uint16_t analogRead(uint8_t pin)
+{
+  return 0;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode)
+{
+  std::lock_guard<std::mutex> lock(pinLock);
+  pinHandlers[pin] = isr;
+}
+
+void detachInterrupt(uint8_t pin)
+{
+  std::lock_guard<std::mutex> lock(pinLock);
+  pinHandlers.erase(pin);
+}
+
+void NativeHal::attachSpiDevice(uint8_t csPin, SpiDevice* device)
+{
+  std::lock_guard<std::mutex> lock(pinLock);
+  spiDevices[csPin] = device;
+}
+
+SpiDevice* NativeHal::selectedSpiDevice()
+{
+  std::lock_guard<std::mutex> lock(pinLock);
+  return selected;
+}
+
+void NativeHal::raiseInterrupt(uint8_t pin)
+{
+  void (*isr)(void) = nullptr;
+  {
+    std::lock_guard<std::mutex> lock(pinLock);
+    auto it = pinHandlers.find(pin);
+    if (it != pinHandlers.end())
+      isr = it->second;
+  }
+  if (isr)
+    isr();
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {}
+
+void ledcDetachPin(uint8_t pin) {}
+
+double ledcWriteTone(uint8_t channel, double freq)
+{
+  return freq;
+}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {}
+
+long random(long max)
+{
+  return max > 0 ? rand() % max : 0;
+}
+
+long random(long min, long max)
+{
+  return max > min ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed)
+{
+  srand(seed);
+}
+
+char* ltoa(long value, char* str, int base)
+{
+  if (base == 10)
+  {
+    sprintf(str, "%ld", value);
+    return str;
+  }
+  return utoa((unsigned long)value, str, base);
+}
+
+char* itoa(int value, char* str, int base)
+{
+  return ltoa(value, str, base);
+}
+
+char* utoa(unsigned value, char* str, int base)
+{
+  strcpy(str, String((unsigned long)value, base).c_str());
+  return str;
+}
+
+char* dtostrf(double value, signed char width, unsigned char prec, char* str)
+{
+  sprintf(str, "%*.*f", width, prec, value);
+  return str;
+}
+
+#if !defined(__GLIBC__) || !__GLIBC_PREREQ(2, 38)
+size_t strlcpy(char* dst, const char* src, size_t size)
+{
+  size_t len = strlen(src);
+  if (size)
+  {
+    size_t n = len < size - 1 ? len : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = 0;
+  }
+  return len;
+}
+#endif
+
+uint32_t getCpuFrequencyMhz()
+{
+  return cpuFrequency;
+}
+
+bool setCpuFrequencyMhz(uint32_t mhz)
+{
+  cpuFrequency = mhz;
+  return true;
+}
+
+uint32_t EspClass::getCycleCount()
+{
+  return (uint32_t)__rdtsc();
+}
+
+void EspClass::restart()
+{
+  Serial.println("ESP.restart() called, exiting");
+  fflush(stdout);
+  _exit(0);
+}
+
+int HardwareSerial::available()
+{
+  return 0;
+}
+
+int HardwareSerial::read()
+{
+  return -1;
+}
+
+int HardwareSerial::peek()
+{
+  return -1;
+}
+
+size_t HardwareSerial::write(uint8_t c)
+{
+  return fwrite(&c, 1, 1, stdout);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size)
+{
+  return fwrite(buffer, 1, size, stdout);
+}
+
+void HardwareSerial::flush()
+{
+  fflush(stdout);
+}
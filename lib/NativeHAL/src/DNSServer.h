@@ -0,0 +1,36 @@
+/*
+  DNSServer.h - DNS server of the native build, the captive portal has no one to answer
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_DNS_SERVER_H
+#define NATIVE_DNS_SERVER_H
+
+#include <Arduino.h>
+
+enum class DNSReplyCode { NoError = 0, FormError = 1, ServerFailure = 2, NonExistentDomain = 3 };
+
+class DNSServer {
+public:
+  bool start(uint16_t port, const String& domainName, const IPAddress& resolvedIP) { return true; }
+  void stop() {}
+  void processNextRequest() {}
+  void setErrorReplyCode(const DNSReplyCode& replyCode) {}
+  void setTTL(const uint32_t ttl) {}
+};
+
+#endif
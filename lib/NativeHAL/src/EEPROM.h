@@ -0,0 +1,45 @@
+/*
+  EEPROM.h - EEPROM of the native build, kept in RAM or in the file named by TINYGS_EEPROM
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <Arduino.h>
+#include <vector>
+
+class EEPROMClass {
+public:
+  bool begin(size_t size);
+  uint8_t read(int address) { return address < (int)data.size() ? data[address] : 0xFF; }
+  void write(int address, uint8_t value)
+  {
+    if (address < (int)data.size())
+      data[address] = value;
+  }
+  bool commit();
+  void end() { commit(); }
+  size_t length() { return data.size(); }
+
+private:
+  std::vector<uint8_t> data;
+};
+
+extern EEPROMClass EEPROM;
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  Esp.h - ESP class of the native build
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_ESP_H
+#define NATIVE_ESP_H
+
+#include <stdint.h>
+
+class EspClass {
+public:
+  uint32_t getFreeHeap() { return 0; }
+  uint32_t getMinFreeHeap() { return 0; }
+  uint32_t getMaxAllocHeap() { return 0; }
+  uint32_t getHeapSize() { return 0; }
+  uint32_t getFreeSketchSpace() { return 0x1E0000; }
+  uint32_t getCpuFreqMHz() { return 240; }
+  const char* getSdkVersion() { return "native"; }
+  uint64_t getEfuseMac() { return 0x0000EFCDAB896745ull; }
+  uint32_t getCycleCount();
+  void restart();
+};
+
+extern EspClass ESP;
+
+#endif
@@ -0,0 +1,302 @@
+/*
+  Esp32Sdk.cpp - ESP-IDF and Arduino-ESP32 services of the native build
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <ESPmDNS.h>
+#include <HTTPUpdate.h>
+#include <Preferences.h>
+#include <Update.h>
+#include <WiFi.h>
+#include <Wire.h>
+#include <base64.h>
+#include <esp_partition.h>
+#include <esp_sleep.h>
+#include <esp_timer.h>
+#include <mbedtls/base64.h>
+#include <rom/crc.h>
+#include <chrono>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+TwoWire Wire;
+WiFiClass WiFi;
+MDNSResponder MDNS;
+EEPROMClass EEPROM;
+UpdateClass Update;
+HTTPUpdate httpUpdate;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+int64_t esp_timer_get_time()
+{
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - bootTime).count();
+}
+
+bool EEPROMClass::begin(size_t size)
+{
+  data.assign(size, 0xFF);
+  const char* path = getenv("TINYGS_EEPROM");
+  FILE* f = path ? fopen(path, "rb") : nullptr;
+  if (f)
+  {
+    size_t n = fread(data.data(), 1, size, f);
+    (void)n;
+    fclose(f);
+  }
+  return true;
+}
+
+bool EEPROMClass::commit()
+{
+  const char* path = getenv("TINYGS_EEPROM");
+  FILE* f = path ? fopen(path, "wb") : nullptr;
+  if (!f)
+    return true;
+  fwrite(data.data(), 1, data.size(), f);
+  fclose(f);
+  return true;
+}
+
+static std::map<std::string, std::vector<uint8_t>> nvs;
+static bool nvsLoaded = false;
+
+// one record per key: key length, key, value length, value
+static void loadNvs()
+{
+  nvsLoaded = true;
+  const char* path = getenv("TINYGS_NVS");
+  FILE* f = path ? fopen(path, "rb") : nullptr;
+  if (!f)
+    return;
+  uint32_t len;
+  while (fread(&len, sizeof(len), 1, f) == 1)
+  {
+    std::string key(len, '\0');
+    std::vector<uint8_t> value;
+    if (fread(&key[0], 1, len, f) != len || fread(&len, sizeof(len), 1, f) != 1)
+      break;
+    value.resize(len);
+    if (fread(value.data(), 1, len, f) != len)
+      break;
+    nvs[key] = value;
+  }
+  fclose(f);
+}
+
+static void saveNvs()
+{
+  const char* path = getenv("TINYGS_NVS");
+  FILE* f = path ? fopen(path, "wb") : nullptr;
+  if (!f)
+    return;
+  for (auto& entry : nvs)
+  {
+    uint32_t len = entry.first.size();
+    fwrite(&len, sizeof(len), 1, f);
+    fwrite(entry.first.data(), 1, len, f);
+    len = entry.second.size();
+    fwrite(&len, sizeof(len), 1, f);
+    fwrite(entry.second.data(), 1, len, f);
+  }
+  fclose(f);
+}
+
+bool Preferences::begin(const char* name, bool ro)
+{
+  if (!nvsLoaded)
+    loadNvs();
+  space = name;
+  readOnly = ro;
+  return true;
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len)
+{
+  if (readOnly)
+    return 0;
+  nvs[path(key)].assign((const uint8_t*)value, (const uint8_t*)value + len);
+  saveNvs();
+  return len;
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen)
+{
+  auto it = nvs.find(path(key));
+  if (it == nvs.end() || it->second.size() > maxLen)
+    return 0;
+  memcpy(buf, it->second.data(), it->second.size());
+  return it->second.size();
+}
+
+size_t Preferences::getBytesLength(const char* key)
+{
+  auto it = nvs.find(path(key));
+  return it == nvs.end() ? 0 : it->second.size();
+}
+
+bool Preferences::remove(const char* key)
+{
+  if (readOnly || !nvs.erase(path(key)))
+    return false;
+  saveNvs();
+  return true;
+}
+
+bool Preferences::clear()
+{
+  if (readOnly)
+    return false;
+  for (auto it = nvs.begin(); it != nvs.end();)
+    it = it->first.compare(0, space.size() + 1, space + "/") ? std::next(it) : nvs.erase(it);
+  saveNvs();
+  return true;
+}
+
+// the default partition table of the ESP32 Arduino core puts spiffs after the two OTA slots
+static esp_partition_t spiffs = {ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, 0x290000, 0x170000, "spiffs", false};
+static std::vector<uint8_t> flash;
+
+// flash writes can only clear bits, exactly as on the chip
+static void syncFlash(size_t offset, size_t size)
+{
+  const char* path = getenv("TINYGS_FLASH");
+  FILE* f = path ? fopen(path, "r+b") : nullptr;
+  if (!f)
+    return;
+  fseek(f, offset, SEEK_SET);
+  fwrite(flash.data() + offset, 1, size, f);
+  fclose(f);
+}
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype, const char* label)
+{
+  if (type != ESP_PARTITION_TYPE_DATA || (subtype != ESP_PARTITION_SUBTYPE_DATA_SPIFFS && subtype != ESP_PARTITION_SUBTYPE_ANY))
+    return nullptr;
+
+  if (flash.empty())
+  {
+    flash.assign(spiffs.size, 0xFF);
+    const char* path = getenv("TINYGS_FLASH");
+    FILE* f = path ? fopen(path, "rb") : nullptr;
+    if (f)
+    {
+      size_t n = fread(flash.data(), 1, flash.size(), f);
+      (void)n;
+      fclose(f);
+    }
+    else if (path && (f = fopen(path, "wb")))
+    {
+      fwrite(flash.data(), 1, flash.size(), f);
+      fclose(f);
+    }
+  }
+  return &spiffs;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size)
+{
+  if (partition != &spiffs || offset + size > flash.size())
+    return ESP_ERR_INVALID_SIZE;
+  memcpy(dst, flash.data() + offset, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size)
+{
+  if (partition != &spiffs || offset + size > flash.size())
+    return ESP_ERR_INVALID_SIZE;
+  for (size_t i = 0; i < size; i++)
+    flash[offset + i] &= ((const uint8_t*)src)[i];
+  syncFlash(offset, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size)
+{
+  if (partition != &spiffs || offset + size > flash.size() || offset % 4096 || size % 4096)
+    return ESP_ERR_INVALID_ARG;
+  memset(flash.data() + offset, 0xFF, size);
+  syncFlash(offset, size);
+  return ESP_OK;
+}
+
+static uint64_t sleepUs = 0;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs)
+{
+  sleepUs = timeUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_light_sleep_start()
+{
+  std::this_thread::sleep_for(std::chrono::microseconds(sleepUs));
+  return ESP_OK;
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause()
+{
+  return ESP_SLEEP_WAKEUP_TIMER;
+}
+
+uint32_t crc32_le(uint32_t crc, const uint8_t* buf, uint32_t len)
+{
+  crc = ~crc;
+  while (len--)
+  {
+    crc ^= *buf++;
+    for (int k = 0; k < 8; k++)
+      crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+  }
+  return ~crc;
+}
+
+static const char base64Alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+int mbedtls_base64_encode(unsigned char* dst, size_t dlen, size_t* olen, const unsigned char* src, size_t slen)
+{
+  size_t needed = (slen + 2) / 3 * 4 + 1;
+  *olen = needed;
+  if (dlen < needed)
+    return MBEDTLS_ERR_BASE64_BUFFER_TOO_SMALL;
+
+  unsigned char* p = dst;
+  for (size_t i = 0; i < slen; i += 3)
+  {
+    uint32_t v = src[i] << 16 | (i + 1 < slen ? src[i + 1] << 8 : 0) | (i + 2 < slen ? src[i + 2] : 0);
+    *p++ = base64Alphabet[v >> 18 & 0x3F];
+    *p++ = base64Alphabet[v >> 12 & 0x3F];
+    *p++ = i + 1 < slen ? base64Alphabet[v >> 6 & 0x3F] : '=';
+    *p++ = i + 2 < slen ? base64Alphabet[v & 0x3F] : '=';
+  }
+  *p = 0;
+  *olen = p - dst;
+  return 0;
+}
+
+String base64::encode(const uint8_t* data, size_t length)
+{
+  std::vector<unsigned char> out((length + 2) / 3 * 4 + 1);
+  size_t olen;
+  mbedtls_base64_encode(out.data(), out.size(), &olen, data, length);
+  return String((const char*)out.data());
+}
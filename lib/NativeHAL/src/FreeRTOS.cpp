@@ -0,0 +1,315 @@
+/*
+  FreeRTOS.cpp - FreeRTOS tasks, semaphores and queues of the native build on std::thread
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "freertos/FreeRTOS.h"
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct NativeTask {
+  std::mutex lock;
+  std::condition_variable notified;
+  uint32_t notifications = 0;
+  BaseType_t core = 0;
+};
+
+struct NativeSemaphore {
+  bool isMutex;
+  std::recursive_timed_mutex mutex;
+  std::mutex lock;
+  std::condition_variable given;
+  UBaseType_t count = 0;
+  UBaseType_t max = 1;
+};
+
+struct NativeQueue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t itemSize;
+};
+
+static thread_local TaskHandle_t currentTask = nullptr;
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+
+// waits on cv until ready() holds or the timeout in ticks expires
+template <typename Ready>
+static bool waitFor(std::condition_variable& cv, std::unique_lock<std::mutex>& lock, TickType_t timeout, Ready ready)
+{
+  if (timeout == portMAX_DELAY)
+  {
+    cv.wait(lock, ready);
+    return true;
+  }
+  return cv.wait_for(lock, std::chrono::milliseconds(timeout * portTICK_PERIOD_MS), ready);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char* name, uint32_t stack, void* param, UBaseType_t priority, TaskHandle_t* handle, BaseType_t core)
+{
+  TaskHandle_t t = new NativeTask();
+  t->core = core == tskNO_AFFINITY ? 0 : core;
+  // the handle is published before the task runs, as the firmware relies on it from the task itself
+  if (handle)
+    *handle = t;
+  std::thread([task, param, t]() {
+    currentTask = t;
+    task(param);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t task, const char* name, uint32_t stack, void* param, UBaseType_t priority, TaskHandle_t* handle)
+{
+  return xTaskCreatePinnedToCore(task, name, stack, param, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+  // threads cannot be killed from outside, tasks only ever delete themselves
+  if (!task || task == currentTask)
+    while (true)
+      std::this_thread::sleep_for(std::chrono::hours(1));
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(ticks * portTICK_PERIOD_MS));
+}
+
+TickType_t xTaskGetTickCount()
+{
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - bootTime).count() / portTICK_PERIOD_MS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle()
+{
+  // the main thread becomes a task the first time it asks
+  if (!currentTask)
+    currentTask = new NativeTask();
+  return currentTask;
+}
+
+BaseType_t xPortGetCoreID()
+{
+  return xTaskGetCurrentTaskHandle()->core;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t timeout)
+{
+  TaskHandle_t t = xTaskGetCurrentTaskHandle();
+  std::unique_lock<std::mutex> lock(t->lock);
+  if (!waitFor(t->notified, lock, timeout, [t]() { return t->notifications > 0; }))
+    return 0;
+  uint32_t value = t->notifications;
+  t->notifications = clear ? 0 : value - 1;
+  return value;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task)
+{
+  {
+    std::lock_guard<std::mutex> lock(task->lock);
+    task->notifications++;
+  }
+  task->notified.notify_one();
+  return pdPASS;
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t* woken)
+{
+  xTaskNotifyGive(task);
+  if (woken)
+    *woken = pdTRUE;
+}
+
+static SemaphoreHandle_t createSemaphore(bool isMutex, UBaseType_t max, UBaseType_t initial)
+{
+  SemaphoreHandle_t s = new NativeSemaphore();
+  s->isMutex = isMutex;
+  s->max = max;
+  s->count = initial;
+  return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex()
+{
+  return createSemaphore(true, 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateRecursiveMutex()
+{
+  return createSemaphore(true, 1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary()
+{
+  return createSemaphore(false, 1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t max, UBaseType_t initial)
+{
+  return createSemaphore(false, max, initial);
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore)
+{
+  delete semaphore;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t timeout)
+{
+  if (s->isMutex)
+  {
+    if (timeout == portMAX_DELAY)
+    {
+      s->mutex.lock();
+      return pdTRUE;
+    }
+    return s->mutex.try_lock_for(std::chrono::milliseconds(timeout * portTICK_PERIOD_MS)) ? pdTRUE : pdFALSE;
+  }
+
+  std::unique_lock<std::mutex> lock(s->lock);
+  if (!waitFor(s->given, lock, timeout, [s]() { return s->count > 0; }))
+    return pdFALSE;
+  s->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s)
+{
+  if (s->isMutex)
+  {
+    s->mutex.unlock();
+    return pdTRUE;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(s->lock);
+    if (s->count >= s->max)
+      return pdFALSE;
+    s->count++;
+  }
+  s->given.notify_one();
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t semaphore, BaseType_t* woken)
+{
+  if (woken)
+    *woken = pdTRUE;
+  return xSemaphoreGive(semaphore);
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize)
+{
+  QueueHandle_t q = new NativeQueue();
+  q->length = length;
+  q->itemSize = itemSize;
+  return q;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+  delete queue;
+}
+
+static BaseType_t queueSend(QueueHandle_t q, const void* item, TickType_t timeout, bool front)
+{
+  {
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!waitFor(q->changed, lock, timeout, [q]() { return q->items.size() < q->length; }))
+      return errQUEUE_FULL;
+    std::vector<uint8_t> copy((const uint8_t*)item, (const uint8_t*)item + q->itemSize);
+    if (front)
+      q->items.push_front(std::move(copy));
+    else
+      q->items.push_back(std::move(copy));
+  }
+  q->changed.notify_all();
+  return pdPASS;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t timeout)
+{
+  return queueSend(queue, item, timeout, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t timeout)
+{
+  return queueSend(queue, item, timeout, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken)
+{
+  if (woken)
+    *woken = pdTRUE;
+  return queueSend(queue, item, 0, false);
+}
+
+static BaseType_t queueReceive(QueueHandle_t q, void* item, TickType_t timeout, bool remove)
+{
+  {
+    std::unique_lock<std::mutex> lock(q->lock);
+    if (!waitFor(q->changed, lock, timeout, [q]() { return !q->items.empty(); }))
+      return pdFALSE;
+    memcpy(item, q->items.front().data(), q->itemSize);
+    if (!remove)
+      return pdTRUE;
+    q->items.pop_front();
+  }
+  q->changed.notify_all();
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t timeout)
+{
+  return queueReceive(queue, item, timeout, true);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* item, TickType_t timeout)
+{
+  return queueReceive(queue, item, timeout, false);
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+  std::lock_guard<std::mutex> lock(q->lock);
+  return q->items.size();
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t q)
+{
+  std::lock_guard<std::mutex> lock(q->lock);
+  return q->length - q->items.size();
+}
+
+BaseType_t xQueueReset(QueueHandle_t q)
+{
+  {
+    std::lock_guard<std::mutex> lock(q->lock);
+    q->items.clear();
+  }
+  q->changed.notify_all();
+  return pdPASS;
+}
@@ -0,0 +1,38 @@
+/*
+  HTTPUpdate.h - OTA over HTTP of the native build, the server never has a newer image
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_HTTP_UPDATE_H
+#define NATIVE_HTTP_UPDATE_H
+
+#include <Arduino.h>
+#include "HTTPClient.h"
+
+enum HTTPUpdateResult { HTTP_UPDATE_FAILED, HTTP_UPDATE_NO_UPDATES, HTTP_UPDATE_OK };
+typedef HTTPUpdateResult t_httpUpdate_return;
+
+class HTTPUpdate {
+public:
+  t_httpUpdate_return update(WiFiClient& client, const String& url, const String& currentVersion = "") { return HTTP_UPDATE_NO_UPDATES; }
+  int getLastError() { return 0; }
+  String getLastErrorString() { return String(); }
+};
+
+extern HTTPUpdate httpUpdate;
+
+#endif
@@ -0,0 +1,47 @@
+/*
+  NativeHal.h - Hooks of the native build to plug simulated peripherals into the pins and the SPI bus
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_HAL_H
+#define NATIVE_HAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// A peripheral on the SPI bus. It is selected when the firmware drives its
+// chip select pin low and sees every byte clocked while it stays selected.
+class SpiDevice {
+public:
+  virtual ~SpiDevice() {}
+  virtual void select() = 0;
+  virtual uint8_t transfer(uint8_t out) = 0;
+  virtual void deselect() = 0;
+};
+
+class NativeHal {
+public:
+  static void attachSpiDevice(uint8_t csPin, SpiDevice* device);
+  static SpiDevice* selectedSpiDevice();
+  // runs the handler attached to the pin, as the GPIO interrupt would
+  static void raiseInterrupt(uint8_t pin);
+  // the loopback broker refuses connections and drops the current one while offline
+  static void setBrokerOnline(bool online);
+  static void brokerPublish(const char* topic, const uint8_t* payload, size_t length);
+};
+
+#endif
@@ -0,0 +1,36 @@
+/*
+  SPI.cpp - Arduino SPI of the native build, bytes go to the simulated device selected
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "SPI.h"
+#include "NativeHal.h"
+
+SPIClass SPI;
+
+uint8_t SPIClass::transfer(uint8_t data)
+{
+  SpiDevice* device = NativeHal::selectedSpiDevice();
+  return device ? device->transfer(data) : 0xFF;
+}
+
+void SPIClass::transfer(void* data, uint32_t size)
+{
+  uint8_t* bytes = (uint8_t*)data;
+  for (uint32_t i = 0; i < size; i++)
+    bytes[i] = transfer(bytes[i]);
+}
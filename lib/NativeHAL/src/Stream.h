@@ -0,0 +1,64 @@
+/*
+  Stream.h - Arduino Stream for the native build
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_STREAM_H
+#define NATIVE_STREAM_H
+
+#include "Print.h"
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+
+  void setTimeout(unsigned long timeout) { this->timeout = timeout; }
+  virtual size_t readBytes(char* buffer, size_t length)
+  {
+    size_t n = 0;
+    while (n < length && available())
+      buffer[n++] = read();
+    return n;
+  }
+  size_t readBytes(uint8_t* buffer, size_t length) { return readBytes((char*)buffer, length); }
+  String readString()
+  {
+    String s;
+    while (available())
+      s += (char)read();
+    return s;
+  }
+  String readStringUntil(char terminator)
+  {
+    String s;
+    while (available())
+    {
+      int c = read();
+      if (c == terminator)
+        break;
+      s += (char)c;
+    }
+    return s;
+  }
+
+protected:
+  unsigned long timeout = 1000;
+};
+
+#endif
@@ -0,0 +1,41 @@
+/*
+  StreamString.h - Arduino StreamString for the native build
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_STREAM_STRING_H
+#define NATIVE_STREAM_STRING_H
+
+#include "Stream.h"
+
+class StreamString : public Stream, public String {
+public:
+  size_t write(uint8_t c) override { concat((char)c); return 1; }
+  using Print::write;
+  int available() override { return length(); }
+  int read() override
+  {
+    if (!length())
+      return -1;
+    char c = charAt(0);
+    remove(0, 1);
+    return (uint8_t)c;
+  }
+  int peek() override { return length() ? (uint8_t)charAt(0) : -1; }
+};
+
+#endif
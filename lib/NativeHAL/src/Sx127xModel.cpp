@@ -0,0 +1,194 @@
+/*
+  Sx127xModel.cpp - Register level model of an SX127x on the simulated SPI bus
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Sx127xModel.h"
+#include <chrono>
+#include <thread>
+#include <math.h>
+#include <stdio.h>
+
+void Sx127xModel::select()
+{
+  lock.lock();
+  selected = true;
+  reg = -1;
+}
+
+void Sx127xModel::deselect()
+{
+  if (!selected)
+    return;
+  selected = false;
+  bool startTx = txStarting;
+  txStarting = false;
+  lock.unlock();
+  changed.notify_all();
+  if (startTx)
+    std::thread(&Sx127xModel::transmit, this).detach();
+}
+
+// the frame "goes on air" for a while, then TX done is raised like the chip does
+void Sx127xModel::transmit()
+{
+  std::this_thread::sleep_for(std::chrono::milliseconds(TX_TIME_MS));
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if ((regs[REG_OP_MODE] & 0x07) != MODE_TX)
+      return; // aborted
+    printf("RADIO> tx ");
+    if (isLoRa())
+    {
+      for (uint8_t i = 0; i < regs[REG_PAYLOAD_LENGTH]; i++)
+        printf("%02x", fifo[(uint8_t)(regs[REG_FIFO_TX_BASE_ADDR] + i)]);
+      regs[REG_IRQ_FLAGS] |= 0x08; // TxDone
+    }
+    else
+    {
+      for (size_t i = 1; i < fskTx.size(); i++)
+        printf("%02x", fskTx[i]);
+      fskTx.clear();
+      regs[REG_IRQ_FLAGS_2] |= 0x08; // PacketSent
+    }
+    printf("\n");
+    fflush(stdout);
+    regs[REG_OP_MODE] = (regs[REG_OP_MODE] & ~0x07) | MODE_STANDBY;
+  }
+  NativeHal::raiseInterrupt(dio0);
+}
+
+// the first byte is the address with the write bit, the following ones burst from it
+uint8_t Sx127xModel::transfer(uint8_t out)
+{
+  if (reg < 0)
+  {
+    reg = out & 0x7F;
+    writing = out & 0x80;
+    return 0;
+  }
+
+  uint8_t in = 0;
+  if (writing)
+    write(reg, out);
+  else
+    in = read(reg);
+  // the FIFO stays on the same address, other registers auto-increment
+  if (reg != REG_FIFO)
+    reg = (reg + 1) & 0x7F;
+  return in;
+}
+
+uint8_t Sx127xModel::read(uint8_t r)
+{
+  if (r == REG_VERSION)
+    return 0x12;
+  if (r != REG_FIFO)
+    return regs[r];
+  if (isLoRa())
+    return fifo[regs[REG_FIFO_ADDR_PTR]++];
+  return fskRead < fskFifo.size() ? fskFifo[fskRead++] : 0;
+}
+
+void Sx127xModel::write(uint8_t r, uint8_t value)
+{
+  if (r == REG_FIFO)
+  {
+    if (isLoRa())
+      fifo[regs[REG_FIFO_ADDR_PTR]++] = value;
+    else
+      fskTx.push_back(value);
+    return;
+  }
+  if (r == REG_OP_MODE && (value & 0x07) == MODE_TX && (regs[r] & 0x07) != MODE_TX)
+    txStarting = true;
+  if (isLoRa() && r == REG_IRQ_FLAGS)
+  {
+    regs[r] &= ~value;
+    return;
+  }
+  if (!isLoRa() && (r == REG_IRQ_FLAGS_1 || r == REG_IRQ_FLAGS_2))
+  {
+    regs[r] = 0;
+    return;
+  }
+  regs[r] = value;
+}
+
+bool Sx127xModel::isListening() const
+{
+  uint8_t mode = regs[REG_OP_MODE] & 0x07;
+  if (isLoRa())
+    return (mode == 0x05 || mode == 0x06) && !(regs[REG_IRQ_FLAGS] & 0x40);
+  return mode == 0x05 && !(regs[REG_IRQ_FLAGS_2] & 0x04);
+}
+
+double Sx127xModel::frequency() const
+{
+  uint32_t frf = (uint32_t)regs[0x06] << 16 | regs[0x07] << 8 | regs[0x08];
+  return frf * 32.0 / (1 << 19);
+}
+
+double Sx127xModel::loRaBandwidth() const
+{
+  static const double bandwidths[] = {7.8, 10.4, 15.6, 20.8, 31.25, 41.7, 62.5, 125.0, 250.0, 500.0};
+  uint8_t bw = regs[REG_MODEM_CONFIG_1] >> 4;
+  return bw < 10 ? bandwidths[bw] : 125.0;
+}
+
+bool Sx127xModel::receive(const std::vector<uint8_t>& payload, float rssi, float snr, float frequencyError, bool crcError)
+{
+  {
+    std::unique_lock<std::mutex> guard(lock);
+    if (!changed.wait_for(guard, std::chrono::seconds(2), [this]() { return isListening(); }))
+      return false;
+
+    if (isLoRa())
+    {
+      uint8_t start = regs[REG_FIFO_ADDR_PTR];
+      for (size_t i = 0; i < payload.size() && i < 255; i++)
+        fifo[(uint8_t)(start + i)] = payload[i];
+      regs[REG_FIFO_RX_CURRENT_ADDR] = start;
+      regs[REG_RX_NB_BYTES] = payload.size();
+      regs[REG_HOP_CHANNEL] |= 0x40; // CRC on in the header
+      regs[REG_PKT_SNR_VALUE] = (uint8_t)(int8_t)lround(snr * 4);
+      // RadioLib adds a negative SNR back to the packet RSSI
+      long raw = lround(rssi - (snr < 0 ? snr : 0)) + (frequency() < 868.0 ? 164 : 157);
+      regs[REG_PKT_RSSI_VALUE] = raw < 0 ? 0 : (raw > 255 ? 255 : raw);
+      int32_t fei = lround(frequencyError * 32000000.0 / (1 << 24) * 500.0 / loRaBandwidth());
+      regs[REG_FEI_MSB] = (fei >> 16) & 0x0F;
+      regs[REG_FEI_MSB + 1] = fei >> 8;
+      regs[REG_FEI_MSB + 2] = fei;
+      regs[REG_IRQ_FLAGS] |= 0x40 | (crcError ? 0x20 : 0);
+    }
+    else
+    {
+      fskFifo.assign(1, payload.size());
+      fskFifo.insert(fskFifo.end(), payload.begin(), payload.end());
+      fskRead = 0;
+      long raw = lround(-2 * rssi);
+      regs[REG_RSSI_VALUE_FSK] = raw < 0 ? 0 : (raw > 255 ? 255 : raw);
+      int32_t fei = lround(frequencyError * (1 << 19) / 32000000.0);
+      regs[REG_FEI_MSB_FSK] = fei >> 8;
+      regs[REG_FEI_MSB_FSK + 1] = fei;
+      regs[REG_IRQ_FLAGS_2] |= 0x04; // PayloadReady
+    }
+  }
+
+  NativeHal::raiseInterrupt(dio0);
+  return true;
+}
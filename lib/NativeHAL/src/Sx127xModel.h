@@ -0,0 +1,87 @@
+/*
+  Sx127xModel.h - Register level model of an SX127x on the simulated SPI bus
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SX127X_MODEL_H
+#define SX127X_MODEL_H
+
+#include "NativeHal.h"
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// Enough of the SX1276/77/78 register map for RadioLib to configure it and
+// read received packets back. Nothing is modulated, receive() puts a frame in
+// the FIFO with the given link statistics and raises DIO0 as the chip would.
+// Transmitted frames are printed prefixed with "RADIO> tx " once TX is done.
+class Sx127xModel : public SpiDevice {
+public:
+  Sx127xModel(uint8_t dio0Pin) : dio0(dio0Pin) {}
+  void select() override;
+  uint8_t transfer(uint8_t out) override;
+  void deselect() override;
+
+  // waits until the firmware has the radio listening, false if it never does
+  bool receive(const std::vector<uint8_t>& payload, float rssi, float snr, float frequencyError, bool crcError);
+
+private:
+  bool isLoRa() const { return regs[REG_OP_MODE] & 0x80; }
+  bool isListening() const;
+  double frequency() const;
+  double loRaBandwidth() const;
+  void transmit();
+  uint8_t read(uint8_t reg);
+  void write(uint8_t reg, uint8_t value);
+
+  static const uint8_t REG_FIFO = 0x00;
+  static const uint8_t REG_OP_MODE = 0x01;
+  static const uint8_t REG_FIFO_ADDR_PTR = 0x0D;
+  static const uint8_t REG_FIFO_RX_CURRENT_ADDR = 0x10;
+  static const uint8_t REG_IRQ_FLAGS = 0x12;
+  static const uint8_t REG_RX_NB_BYTES = 0x13;
+  static const uint8_t REG_PKT_SNR_VALUE = 0x19;
+  static const uint8_t REG_PKT_RSSI_VALUE = 0x1A;
+  static const uint8_t REG_HOP_CHANNEL = 0x1C;
+  static const uint8_t REG_MODEM_CONFIG_1 = 0x1D;
+  static const uint8_t REG_FEI_MSB = 0x28;
+  static const uint8_t REG_VERSION = 0x42;
+  static const uint8_t REG_RSSI_VALUE_FSK = 0x11;
+  static const uint8_t REG_FEI_MSB_FSK = 0x1D;
+  static const uint8_t REG_IRQ_FLAGS_1 = 0x3E;
+  static const uint8_t REG_IRQ_FLAGS_2 = 0x3F;
+  static const uint8_t REG_FIFO_TX_BASE_ADDR = 0x0E;
+  static const uint8_t REG_PAYLOAD_LENGTH = 0x22;
+  static const uint8_t MODE_STANDBY = 0x01;
+  static const uint8_t MODE_TX = 0x03;
+  static const int TX_TIME_MS = 50;
+
+  uint8_t dio0;
+  std::mutex lock;
+  std::condition_variable changed;
+  bool selected = false;
+  int reg = -1;      // register of the current transaction, -1 until the address byte
+  bool writing = false;
+  uint8_t regs[128] = {};
+  uint8_t fifo[256] = {};
+  std::vector<uint8_t> fskFifo;
+  size_t fskRead = 0;
+  std::vector<uint8_t> fskTx;
+  bool txStarting = false; // set by the write that enters TX, acted on once the bus is released
+};
+
+#endif
@@ -0,0 +1,38 @@
+/*
+  Update.h - Firmware update of the native build, images are accepted and discarded
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_UPDATE_H
+#define NATIVE_UPDATE_H
+
+#include <Arduino.h>
+
+#define UPDATE_SIZE_UNKNOWN 0xFFFFFFFF
+
+class UpdateClass {
+public:
+  bool begin(size_t size = UPDATE_SIZE_UNKNOWN) { return true; }
+  size_t write(uint8_t* data, size_t length) { return length; }
+  bool end(bool evenIfRemaining = false) { return true; }
+  bool hasError() { return false; }
+  void printError(Print& out) { out.println("native build, no update error"); }
+};
+
+extern UpdateClass Update;
+
+#endif
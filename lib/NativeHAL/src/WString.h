@@ -0,0 +1,164 @@
+/*
+  WString.h - Arduino String for the native build, backed by std::string
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_WSTRING_H
+#define NATIVE_WSTRING_H
+
+#include <string>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
+
+class __FlashStringHelper;
+#define FPSTR(s) (reinterpret_cast<const __FlashStringHelper *>(s))
+#define F(s) FPSTR(s)
+
+class String {
+public:
+  String(const char* c = "") : s(c ? c : "") {}
+  String(const __FlashStringHelper* c) : s(c ? (const char*)c : "") {}
+  String(const std::string& x) : s(x) {}
+  explicit String(char c) : s(1, c) {}
+  explicit String(unsigned char v, unsigned char base = 10) { fromInt(v, base); }
+  explicit String(int v, unsigned char base = 10) { fromInt(v, base); }
+  explicit String(unsigned int v, unsigned char base = 10) { fromInt(v, base); }
+  explicit String(long v, unsigned char base = 10) { fromInt(v, base); }
+  explicit String(unsigned long v, unsigned char base = 10) { fromInt(v, base); }
+  explicit String(long long v, unsigned char base = 10) { fromInt(v, base); }
+  explicit String(unsigned long long v, unsigned char base = 10) { fromInt(v, base); }
+  explicit String(float v, unsigned char decimals = 2) { fromFloat(v, decimals); }
+  explicit String(double v, unsigned char decimals = 2) { fromFloat(v, decimals); }
+
+  const char* c_str() const { return s.c_str(); }
+  unsigned int length() const { return s.size(); }
+  bool reserve(unsigned int n) { s.reserve(n); return true; }
+  char operator[](unsigned int i) const { return i < s.size() ? s[i] : 0; }
+  char& operator[](unsigned int i) { return s[i]; }
+  char charAt(unsigned int i) const { return (*this)[i]; }
+  void setCharAt(unsigned int i, char c) { if (i < s.size()) s[i] = c; }
+
+  bool concat(const String& o) { s += o.s; return true; }
+  bool concat(const char* o) { if (o) s += o; return true; }
+  bool concat(const char* o, unsigned int n) { s.append(o, n); return true; }
+  bool concat(char c) { s += c; return true; }
+  bool concat(int v) { return concat(String(v)); }
+  bool concat(unsigned int v) { return concat(String(v)); }
+  bool concat(long v) { return concat(String(v)); }
+  bool concat(unsigned long v) { return concat(String(v)); }
+  bool concat(float v) { return concat(String(v)); }
+  bool concat(double v) { return concat(String(v)); }
+  bool concat(unsigned char v) { return concat(String(v)); }
+  bool concat(long long v) { return concat(String(v)); }
+  bool concat(unsigned long long v) { return concat(String(v)); }
+  bool concat(const __FlashStringHelper* o) { return concat((const char*)o); }
+  template <typename T> String& operator+=(const T& v) { concat(v); return *this; }
+
+  bool operator==(const String& o) const { return s == o.s; }
+  bool operator==(const char* o) const { return s == (o ? o : ""); }
+  bool operator!=(const String& o) const { return !(*this == o); }
+  bool operator!=(const char* o) const { return !(*this == o); }
+  bool operator<(const String& o) const { return s < o.s; }
+  bool operator>(const String& o) const { return s > o.s; }
+  int compareTo(const String& o) const { return s.compare(o.s); }
+  bool equals(const String& o) const { return s == o.s; }
+  bool equalsIgnoreCase(const String& o) const { return strcasecmp(s.c_str(), o.s.c_str()) == 0; }
+  bool startsWith(const String& o) const { return s.compare(0, o.s.size(), o.s) == 0; }
+  bool endsWith(const String& o) const { return s.size() >= o.s.size() && s.compare(s.size() - o.s.size(), o.s.size(), o.s) == 0; }
+
+  int indexOf(char c, unsigned int from = 0) const { return pos(s.find(c, from)); }
+  int indexOf(const String& o, unsigned int from = 0) const { return pos(s.find(o.s, from)); }
+  int lastIndexOf(char c) const { return pos(s.rfind(c)); }
+  int lastIndexOf(const String& o) const { return pos(s.rfind(o.s)); }
+  String substring(unsigned int b) const { return b < s.size() ? String(s.substr(b)) : String(); }
+  String substring(unsigned int b, unsigned int e) const { return b < s.size() && e > b ? String(s.substr(b, e - b)) : String(); }
+
+  void replace(char f, char r) { for (auto& c : s) if (c == f) c = r; }
+  void replace(const String& f, const String& r)
+  {
+    if (f.s.empty())
+      return;
+    for (size_t p = 0; (p = s.find(f.s, p)) != std::string::npos; p += r.s.size())
+      s.replace(p, f.s.size(), r.s);
+  }
+  void remove(unsigned int i) { if (i < s.size()) s.erase(i); }
+  void remove(unsigned int i, unsigned int n) { if (i < s.size()) s.erase(i, n); }
+  void toLowerCase() { for (auto& c : s) c = tolower(c); }
+  void toUpperCase() { for (auto& c : s) c = toupper(c); }
+  void trim()
+  {
+    size_t b = s.find_first_not_of(" \t\r\n");
+    size_t e = s.find_last_not_of(" \t\r\n");
+    s = b == std::string::npos ? "" : s.substr(b, e - b + 1);
+  }
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return atof(s.c_str()); }
+  double toDouble() const { return atof(s.c_str()); }
+  void toCharArray(char* buf, unsigned int n, unsigned int idx = 0) const { getBytes((unsigned char*)buf, n, idx); }
+  void getBytes(unsigned char* buf, unsigned int n, unsigned int idx = 0) const
+  {
+    if (!n)
+      return;
+    size_t len = idx < s.size() ? s.size() - idx : 0;
+    if (len > n - 1)
+      len = n - 1;
+    memcpy(buf, s.c_str() + (idx < s.size() ? idx : 0), len);
+    buf[len] = 0;
+  }
+
+  friend String operator+(const String& a, const String& b) { return String(a.s + b.s); }
+  friend String operator+(const String& a, const char* b) { return String(a.s + (b ? b : "")); }
+  friend String operator+(const char* a, const String& b) { return String(std::string(a ? a : "") + b.s); }
+  friend String operator+(const String& a, char b) { return String(a.s + b); }
+  template <typename T> friend String operator+(const String& a, T b) { String r(a); r.concat(b); return r; }
+
+private:
+  static int pos(size_t p) { return p == std::string::npos ? -1 : (int)p; }
+  template <typename T> void fromInt(T v, unsigned char base)
+  {
+    if (base == 10)
+    {
+      s = std::to_string(v);
+      return;
+    }
+    unsigned long long u = (unsigned long long)v;
+    do
+    {
+      s.insert(s.begin(), "0123456789abcdefghijklmnopqrstuvwxyz"[u % base]);
+      u /= base;
+    } while (u);
+  }
+  void fromFloat(double v, unsigned char decimals)
+  {
+    char b[64];
+    snprintf(b, sizeof(b), "%.*f", decimals, v);
+    s = b;
+  }
+
+  std::string s;
+};
+
+class StringSumHelper : public String {
+public:
+  StringSumHelper(const String& s) : String(s) {}
+  StringSumHelper(const char* p) : String(p) {}
+};
+
+#endif
@@ -0,0 +1,82 @@
+/*
+  WebServer.h - Web server of the native build, nothing listens on the host
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_WEB_SERVER_H
+#define NATIVE_WEB_SERVER_H
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+#define HTTP_DOWNLOAD_UNIT_SIZE 1436
+#define HTTP_UPLOAD_BUFLEN 1436
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+typedef enum { HTTP_ANY, HTTP_GET, HTTP_HEAD, HTTP_POST, HTTP_PUT, HTTP_PATCH, HTTP_DELETE, HTTP_OPTIONS } HTTPMethod;
+enum HTTPUploadStatus { UPLOAD_FILE_START, UPLOAD_FILE_WRITE, UPLOAD_FILE_END, UPLOAD_FILE_ABORTED };
+enum HTTPAuthMethod { BASIC_AUTH, DIGEST_AUTH };
+
+typedef struct {
+  HTTPUploadStatus status;
+  String filename;
+  String name;
+  String type;
+  size_t totalSize;
+  size_t currentSize;
+  uint8_t buf[HTTP_UPLOAD_BUFLEN];
+} HTTPUpload;
+
+class WebServer {
+public:
+  typedef std::function<void(void)> THandlerFunction;
+
+  WebServer(int port = 80) {}
+  void begin() {}
+  void handleClient() {}
+  void on(const String& uri, THandlerFunction handler) {}
+  void on(const String& uri, HTTPMethod method, THandlerFunction handler) {}
+  void on(const String& uri, HTTPMethod method, THandlerFunction handler, THandlerFunction upload) {}
+  void onNotFound(THandlerFunction handler) {}
+
+  String uri() { return String("/"); }
+  String hostHeader() { return String("127.0.0.1"); }
+  String arg(const String& name) { return String(); }
+  bool hasArg(const String& name) { return false; }
+  int args() { return 0; }
+  HTTPMethod method() { return HTTP_GET; }
+  WiFiClient& client() { return currentClient; }
+  HTTPUpload& upload() { return currentUpload; }
+  bool authenticate(const char* username, const char* password) { return true; }
+  void requestAuthentication(HTTPAuthMethod mode = BASIC_AUTH, const char* realm = nullptr, const String& failMessage = String()) {}
+
+  void send(int code, const char* contentType = nullptr, const String& content = String()) {}
+  void send(int code, const __FlashStringHelper* contentType, const String& content) {}
+  void send(int code, const String& contentType, const String& content) {}
+  void send_P(int code, PGM_P contentType, PGM_P content) {}
+  void send_P(int code, PGM_P contentType, PGM_P content, size_t length) {}
+  void sendHeader(const String& name, const String& value, bool first = false) {}
+  void sendContent(const String& content) {}
+  void sendContent_P(PGM_P content) {}
+  void setContentLength(const size_t length) {}
+
+private:
+  WiFiClient currentClient;
+  HTTPUpload currentUpload;
+};
+
+#endif
@@ -0,0 +1,62 @@
+/*
+  WiFi.h - WiFi of the native build, the station is always connected
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_WIFI_H
+#define NATIVE_WIFI_H
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+  WIFI_OFF = 0,
+  WIFI_STA = 1,
+  WIFI_AP = 2,
+  WIFI_AP_STA = 3
+} wifi_mode_t;
+
+class WiFiClass {
+public:
+  wl_status_t begin(const char* ssid, const char* password = nullptr) { return WL_CONNECTED; }
+  bool disconnect(bool wifiOff = false) { return true; }
+  wl_status_t status() { return WL_CONNECTED; }
+  bool isConnected() { return true; }
+  bool mode(wifi_mode_t mode) { return true; }
+  bool setHostname(const char* name) { return true; }
+  bool hostname(const char* name) { return true; }
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+  IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+  bool softAP(const char* ssid, const char* password = nullptr) { return true; }
+  bool softAPdisconnect(bool wifiOff = false) { return true; }
+  uint8_t softAPgetStationNum() { return 0; }
+  int8_t RSSI() { return -50; }
+  String macAddress() { return String("AA:BB:CC:DD:EE:FF"); }
+};
+
+extern WiFiClass WiFi;
+
+#endif
@@ -0,0 +1,221 @@
+/*
+  WiFiClient.cpp - TCP client of the native build, every connection ends in the loopback MQTT broker
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "WiFiClient.h"
+#include "NativeHal.h"
+#include <Arduino.h>
+
+static bool brokerOnline = true;
+static WiFiClient* brokerSession = nullptr;
+
+void NativeHal::setBrokerOnline(bool online)
+{
+  brokerOnline = online;
+  if (!online && brokerSession)
+    brokerSession->stop();
+}
+
+void NativeHal::brokerPublish(const char* topic, const uint8_t* payload, size_t length)
+{
+  if (brokerSession)
+    brokerSession->deliver(topic, payload, length);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port)
+{
+  return connect(ip.toString().c_str(), port);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port)
+{
+  if (!brokerOnline)
+    return 0;
+  std::lock_guard<std::mutex> guard(lock);
+  open = true;
+  outbound.clear();
+  inbound.clear();
+  brokerSession = this;
+  return 1;
+}
+
+void WiFiClient::stop()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  open = false;
+  inbound.clear();
+  if (brokerSession == this)
+    brokerSession = nullptr;
+}
+
+uint8_t WiFiClient::connected()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return open;
+}
+
+size_t WiFiClient::write(uint8_t c)
+{
+  return write(&c, 1);
+}
+
+// packets may arrive split across several writes, they are handled once complete
+size_t WiFiClient::write(const uint8_t* buffer, size_t size)
+{
+  std::vector<std::vector<uint8_t>> packets;
+  {
+    std::lock_guard<std::mutex> guard(lock);
+    if (!open)
+      return 0;
+    outbound.insert(outbound.end(), buffer, buffer + size);
+
+    while (outbound.size() >= 2)
+    {
+      size_t length = 0;
+      size_t pos = 1;
+      uint32_t multiplier = 1;
+      bool complete = false;
+      while (pos < outbound.size() && pos < 5)
+      {
+        uint8_t digit = outbound[pos++];
+        length += (digit & 0x7F) * multiplier;
+        multiplier <<= 7;
+        if (!(digit & 0x80))
+        {
+          complete = true;
+          break;
+        }
+      }
+      if (!complete || outbound.size() < pos + length)
+        break;
+      packets.emplace_back(outbound.begin(), outbound.begin() + pos + length);
+      outbound.erase(outbound.begin(), outbound.begin() + pos + length);
+    }
+  }
+
+  for (auto& packet : packets)
+    handlePacket(packet);
+  return size;
+}
+
+void WiFiClient::handlePacket(const std::vector<uint8_t>& packet)
+{
+  size_t header = 2;
+  while (packet[header - 1] & 0x80)
+    header++;
+
+  switch (packet[0] & 0xF0)
+  {
+    case 0x10: // CONNECT
+    {
+      const uint8_t connack[] = {0x20, 0x02, 0x00, 0x00};
+      reply(connack, sizeof(connack));
+      break;
+    }
+    case 0x30: // PUBLISH
+    {
+      uint16_t topicLength = packet[header] << 8 | packet[header + 1];
+      std::string topic((const char*)&packet[header + 2], topicLength);
+      size_t payload = header + 2 + topicLength + ((packet[0] & 0x06) ? 2 : 0);
+      bool binary = false;
+      for (size_t i = payload; i < packet.size(); i++)
+        if (packet[i] < 0x20 || packet[i] > 0x7E)
+          binary = true;
+
+      Serial.printf("MQTT> %s ", topic.c_str());
+      for (size_t i = payload; i < packet.size(); i++)
+        Serial.printf(binary ? "%02x" : "%c", packet[i]);
+      Serial.println();
+      break;
+    }
+    case 0x80: // SUBSCRIBE, every topic is granted QoS 0
+    {
+      std::vector<uint8_t> suback = {0x90, 0x02, packet[header], packet[header + 1]};
+      for (size_t pos = header + 2; pos + 2 < packet.size(); pos += 3 + (packet[pos] << 8 | packet[pos + 1]))
+      {
+        suback.push_back(0x00);
+        suback[1]++;
+      }
+      reply(suback.data(), suback.size());
+      break;
+    }
+    case 0xC0: // PINGREQ
+    {
+      const uint8_t pingresp[] = {0xD0, 0x00};
+      reply(pingresp, sizeof(pingresp));
+      break;
+    }
+    case 0xE0: // DISCONNECT
+      stop();
+      break;
+  }
+}
+
+void WiFiClient::deliver(const char* topic, const uint8_t* payload, size_t length)
+{
+  std::vector<uint8_t> packet = {0x30};
+  size_t remaining = 2 + strlen(topic) + length;
+  do
+  {
+    uint8_t digit = remaining & 0x7F;
+    remaining >>= 7;
+    packet.push_back(remaining ? digit | 0x80 : digit);
+  } while (remaining);
+  packet.push_back(strlen(topic) >> 8);
+  packet.push_back(strlen(topic) & 0xFF);
+  packet.insert(packet.end(), topic, topic + strlen(topic));
+  packet.insert(packet.end(), payload, payload + length);
+  reply(packet.data(), packet.size());
+}
+
+void WiFiClient::reply(const uint8_t* bytes, size_t length)
+{
+  std::lock_guard<std::mutex> guard(lock);
+  inbound.insert(inbound.end(), bytes, bytes + length);
+}
+
+int WiFiClient::available()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return inbound.size();
+}
+
+int WiFiClient::read()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  if (inbound.empty())
+    return -1;
+  uint8_t c = inbound.front();
+  inbound.pop_front();
+  return c;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size)
+{
+  size_t n = 0;
+  int c;
+  while (n < size && (c = read()) >= 0)
+    buffer[n++] = c;
+  return n;
+}
+
+int WiFiClient::peek()
+{
+  std::lock_guard<std::mutex> guard(lock);
+  return inbound.empty() ? -1 : inbound.front();
+}
@@ -0,0 +1,61 @@
+/*
+  WiFiClient.h - TCP client of the native build, every connection ends in the loopback MQTT broker
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef NATIVE_WIFI_CLIENT_H
+#define NATIVE_WIFI_CLIENT_H
+
+#include "Client.h"
+#include <deque>
+#include <mutex>
+#include <vector>
+
+class WiFiClient : public Client {
+public:
+  int connect(IPAddress ip, uint16_t port) override;
+  int connect(const char* host, uint16_t port) override;
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  int available() override;
+  int read() override;
+  int read(uint8_t* buffer, size_t size) override;
+  int peek() override;
+  void flush() override {}
+  void stop() override;
+  uint8_t connected() override;
+  operator bool() override { return connected(); }
+  void setNoDelay(bool) {}
+  IPAddress localIP() { return IPAddress(127, 0, 0, 1); }
+  uint16_t localPort() { return 80; }
+  void setTimeout(uint32_t) {}
+
+  // queued as a PUBLISH from the broker, as if someone else had published it
+  void deliver(const char* topic, const uint8_t* payload, size_t length);
+
+private:
+  void handlePacket(const std::vector<uint8_t>& packet);
+  void reply(const uint8_t* bytes, size_t length);
+
+  bool open = false;
+  std::mutex lock;
+  std::vector<uint8_t> outbound; // bytes written by the firmware not parsed yet
+  std::deque<uint8_t> inbound;   // broker replies waiting to be read
+};
+
+#endif
@@ -0,0 +1,171 @@
+/*
+  test_rs_parity.c - rscode tables and parity against the runtime-built originals
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Run with: pio test -e native
+#include <unity.h>
+#include <stdlib.h>
+#include <string.h>
+
+// the library is built into the test, nothing from the station is needed
+#include "../../tinyGS/src/Radio/correct/rs/galois.c"
+#include "../../tinyGS/src/Radio/correct/rs/berlekamp.c"
+#include "../../tinyGS/src/Radio/correct/rs/rs.c"
+
+#define MESSAGES 2000
+
+// The field, generator and encoder exactly as rscode built and ran them
+// before they became flash tables, so nothing is shared with the code
+// under test
+static int refExp[512];
+static int refLog[256];
+static int refGenPoly[NPAR + 1];
+
+static int refMult(int a, int b)
+{
+  if (a == 0 || b == 0)
+    return 0;
+  return refExp[refLog[a] + refLog[b]];
+}
+
+static void buildReference(void)
+{
+  int i, z;
+  int pinit, p1, p2, p3, p4, p5, p6, p7, p8;
+
+  pinit = p2 = p3 = p4 = p5 = p6 = p7 = p8 = 0;
+  p1 = 1;
+  refExp[0] = 1;
+  refExp[255] = refExp[0];
+  refLog[0] = 0;
+  for (i = 1; i < 256; i++)
+  {
+    pinit = p8;
+    p8 = p7;
+    p7 = p6;
+    p6 = p5;
+    p5 = p4 ^ pinit;
+    p4 = p3 ^ pinit;
+    p3 = p2 ^ pinit;
+    p2 = p1;
+    p1 = pinit;
+    refExp[i] = p1 + p2 * 2 + p3 * 4 + p4 * 8 + p5 * 16 + p6 * 32 + p7 * 64 + p8 * 128;
+    refExp[i + 255] = refExp[i];
+  }
+  for (i = 1; i < 256; i++)
+    for (z = 0; z < 256; z++)
+      if (refExp[z] == i)
+      {
+        refLog[i] = z;
+        break;
+      }
+
+  // prod(x + a^n) for n = 1 to NPAR, lowest order first
+  memset(refGenPoly, 0, sizeof(refGenPoly));
+  refGenPoly[0] = 1;
+  for (i = 1; i <= NPAR; i++)
+  {
+    int next[NPAR + 1] = {0};
+    for (z = 0; z < i; z++)
+    {
+      next[z] ^= refMult(refGenPoly[z], refExp[i]);
+      next[z + 1] ^= refGenPoly[z];
+    }
+    memcpy(refGenPoly, next, sizeof(next));
+  }
+}
+
+static void refEncode(const unsigned char msg[], int nbytes, unsigned char dst[])
+{
+  int i, j, dbyte, LFSR[NPAR + 1] = {0};
+
+  for (i = 0; i < nbytes; i++)
+  {
+    dbyte = msg[i] ^ LFSR[NPAR - 1];
+    for (j = NPAR - 1; j > 0; j--)
+      LFSR[j] = LFSR[j - 1] ^ refMult(refGenPoly[j], dbyte);
+    LFSR[0] = refMult(refGenPoly[0], dbyte);
+  }
+  memcpy(dst, msg, nbytes);
+  for (i = 0; i < NPAR; i++)
+    dst[i + nbytes] = LFSR[NPAR - 1 - i];
+}
+
+void setUp(void)
+{
+  buildReference();
+  initialize_ecc();
+}
+
+void tearDown(void) {}
+
+void test_tables_match_runtime_build(void)
+{
+  for (int i = 0; i < 510; i++)
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(refExp[i], gexp[i], "gexp");
+  for (int i = 1; i < 256; i++)
+    TEST_ASSERT_EQUAL_HEX8_MESSAGE(refLog[i], glog[i], "glog");
+}
+
+void test_parity_matches_lfsr_encoder(void)
+{
+  unsigned char msg[255 - NPAR], expected[255], actual[255];
+  rs_state st;
+
+  srand(1);
+  for (int n = 0; n < MESSAGES; n++)
+  {
+    int length = 1 + rand() % (255 - NPAR);
+    for (int i = 0; i < length; i++)
+      msg[i] = rand();
+
+    refEncode(msg, length, expected);
+    rs_init_state(&st);
+    encode_data(&st, msg, length, actual);
+    TEST_ASSERT_EQUAL_HEX8_ARRAY(expected, actual, length + NPAR);
+  }
+}
+
+// the parity of a clean codeword leaves every syndrome at zero
+void test_codewords_have_zero_syndrome(void)
+{
+  unsigned char msg[255 - NPAR], codeword[255];
+  rs_state st;
+
+  srand(2);
+  for (int n = 0; n < MESSAGES; n++)
+  {
+    int length = 1 + rand() % (255 - NPAR);
+    for (int i = 0; i < length; i++)
+      msg[i] = rand();
+
+    rs_init_state(&st);
+    encode_data(&st, msg, length, codeword);
+    decode_data(&st, codeword, length + NPAR);
+    TEST_ASSERT_EQUAL_UINT8(0, check_syndrome(&st));
+  }
+}
+
+int main(int argc, char **argv)
+{
+  UNITY_BEGIN();
+  RUN_TEST(test_tables_match_runtime_build);
+  RUN_TEST(test_parity_matches_lfsr_encoder);
+  RUN_TEST(test_codewords_have_zero_syndrome);
+  return UNITY_END();
+}
@@ -0,0 +1,218 @@
+/*
+  FecBench.cpp - Host throughput benchmark of the FEC codecs
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+// Built only by the bench env:  pio run -e bench && .pio/build/bench/program
+#ifdef FEC_BENCH
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "../src/Radio/correct/rs/ecc.h"
+#include "../src/Radio/correct/reed-solomon.h"
+extern "C" {
+#include "../src/Radio/convolutional/convolutional.h"
+}
+
+#define RS_MSG_LEN (255 - NPAR)
+#define RS_ROUNDS 20000
+#define CONV_MSG_LEN 255
+#define CONV_ROUNDS 400
+
+static uint32_t rngState = 1;
+static uint32_t rng()
+{
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 17;
+  rngState ^= rngState << 5;
+  return rngState;
+}
+
+static double seconds(std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// encode_data before the parity table: one gmult per generator coefficient and input byte
+static int genPoly[NPAR + 1];
+
+static void buildGenPoly()
+{
+  memset(genPoly, 0, sizeof(genPoly));
+  genPoly[0] = 1;
+  for (int n = 1; n <= NPAR; n++)
+    for (int j = n; j >= 0; j--)
+      genPoly[j] = (j ? genPoly[j - 1] : 0) ^ gmult(genPoly[j], gexp[n]);
+}
+
+static void lfsrEncode(const uint8_t* msg, int nbytes, uint8_t* dst)
+{
+  int LFSR[NPAR + 1] = {0};
+  for (int i = 0; i < nbytes; i++) {
+    int dbyte = msg[i] ^ LFSR[NPAR - 1];
+    for (int j = NPAR - 1; j > 0; j--)
+      LFSR[j] = LFSR[j - 1] ^ gmult(genPoly[j], dbyte);
+    LFSR[0] = gmult(genPoly[0], dbyte);
+  }
+  memcpy(dst, msg, nbytes);
+  for (int i = 0; i < NPAR; i++)
+    dst[i + nbytes] = LFSR[NPAR - 1 - i];
+}
+
+static void benchRsEncode()
+{
+  static uint8_t msgs[16][RS_MSG_LEN];
+  uint8_t table[RS_MSG_LEN + NPAR], lfsr[RS_MSG_LEN + NPAR], libcorrect[RS_MSG_LEN + NPAR];
+  for (auto& m : msgs)
+    for (auto& b : m)
+      b = rng();
+
+  initialize_ecc();
+  buildGenPoly();
+  correct_reed_solomon* rs = correct_reed_solomon_create(correct_rs_primitive_polynomial_8_4_3_2_0, 1, 1, NPAR);
+
+  // all three must agree before their speed means anything
+  rs_state st;
+  for (auto& m : msgs) {
+    encode_data(&st, m, RS_MSG_LEN, table);
+    lfsrEncode(m, RS_MSG_LEN, lfsr);
+    correct_reed_solomon_encode(rs, m, RS_MSG_LEN, libcorrect);
+    if (memcmp(table, lfsr, sizeof(table)) || memcmp(table, libcorrect, sizeof(table))) {
+      printf("RS encoders disagree, aborting\n");
+      exit(1);
+    }
+  }
+
+  double mb = (double)RS_MSG_LEN * RS_ROUNDS / 1e6;
+  uint32_t sink = 0;
+  printf("RS(255,%d) encode, %d byte messages\n", RS_MSG_LEN, RS_MSG_LEN);
+
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RS_ROUNDS; i++) {
+    encode_data(&st, msgs[i & 15], RS_MSG_LEN, table);
+    sink += table[RS_MSG_LEN];
+  }
+  printf("  parity table   %8.2f MB/s\n", mb / seconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RS_ROUNDS; i++) {
+    lfsrEncode(msgs[i & 15], RS_MSG_LEN, lfsr);
+    sink += lfsr[RS_MSG_LEN];
+  }
+  printf("  gmult LFSR     %8.2f MB/s\n", mb / seconds(start));
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < RS_ROUNDS; i++) {
+    correct_reed_solomon_encode(rs, msgs[i & 15], RS_MSG_LEN, libcorrect);
+    sink += libcorrect[RS_MSG_LEN];
+  }
+  printf("  libcorrect     %8.2f MB/s\n", mb / seconds(start));
+
+  correct_reed_solomon_destroy(rs);
+  if (sink == 0xFFFFFFFF)
+    printf("\n");
+}
+
+// one standard normal sample, Box-Muller over the xorshift generator
+static double gaussian()
+{
+  double u1 = (rng() + 1.0) / 4294967297.0;
+  double u2 = (rng() + 1.0) / 4294967297.0;
+  return sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// BPSK at +-1 through AWGN, quantised to the soft symbols the decoder takes,
+// 0 for a confident 0 bit and 255 for a confident 1
+static void addNoise(const uint8_t* encoded, size_t bits, double ebN0dB, uint8_t* soft)
+{
+  double ebN0 = pow(10.0, ebN0dB / 10.0);
+  double sigma = sqrt(1.0 / (2.0 * ebN0 / RATE_CON));
+  for (size_t i = 0; i < bits; i++) {
+    double v = ((encoded[i / 8] >> (7 - i % 8)) & 1 ? 1.0 : -1.0) + sigma * gaussian();
+    double s = 127.5 + 127.5 * v;
+    soft[i] = s < 0 ? 0 : s > 255 ? 255 : (uint8_t)s;
+  }
+}
+
+static unsigned bitErrors(const uint8_t* a, const uint8_t* b, size_t len)
+{
+  unsigned errors = 0;
+  for (size_t i = 0; i < len; i++)
+    errors += __builtin_popcount(a[i] ^ b[i]);
+  return errors;
+}
+
+static void benchViterbi()
+{
+  static uint8_t msg[CONV_MSG_LEN], decoded[CONV_MSG_LEN + 1];
+  for (auto& b : msg)
+    b = rng();
+
+  correct_convolutional* packed = correct_convolutional_create(RATE_CON, ORDER_CON, correct_conv_r12_7_polynomial);
+  correct_convolutional* scalar = correct_convolutional_create(RATE_CON, ORDER_CON, correct_conv_r12_7_polynomial);
+  size_t bits = correct_convolutional_encode_len(packed, CONV_MSG_LEN);
+  uint8_t* encoded = (uint8_t*)malloc((bits + 7) / 8);
+  uint8_t* soft = (uint8_t*)malloc(bits);
+  correct_convolutional_encode(packed, msg, CONV_MSG_LEN, encoded);
+
+  // the decoder builds its acs lookup on first use; hiding it afterwards
+  // sends the second instance down the one-butterfly-at-a-time path
+  addNoise(encoded, bits, 10.0, soft);
+  correct_convolutional_decode_soft(packed, soft, bits, decoded);
+  correct_convolutional_decode_soft(scalar, soft, bits, decoded);
+  uint32_t* masks = scalar->acs.masks;
+  scalar->acs.masks = NULL;
+  if (!packed->acs.masks)
+    printf("no packed acs kernel for this code, both rows run the scalar path\n");
+
+  double mbit = 8.0 * CONV_MSG_LEN * CONV_ROUNDS / 1e6;
+  printf("\nK=7 r=1/2 soft Viterbi, %d byte messages, %d-state lanes\n", CONV_MSG_LEN, ACS_LANES);
+  printf("  Eb/N0   packed Mbit/s  errors   scalar Mbit/s  errors\n");
+  const double points[] = {2.0, 3.0, 4.0, 5.0, 6.0};
+  for (double ebN0 : points) {
+    addNoise(encoded, bits, ebN0, soft);
+    unsigned errors[2] = {0, 0};
+    double rate[2];
+    correct_convolutional* codecs[2] = {packed, scalar};
+    for (int c = 0; c < 2; c++) {
+      auto start = std::chrono::steady_clock::now();
+      for (int i = 0; i < CONV_ROUNDS; i++)
+        correct_convolutional_decode_soft(codecs[c], soft, bits, decoded);
+      rate[c] = mbit / seconds(start);
+      errors[c] = bitErrors(msg, decoded, CONV_MSG_LEN);
+    }
+    if (errors[0] != errors[1])
+      printf("  packed and scalar decodes differ\n");
+    printf("  %4.1f dB  %13.2f  %6u  %14.2f  %6u\n", ebN0, rate[0], errors[0], rate[1], errors[1]);
+  }
+
+  scalar->acs.masks = masks;
+  free(encoded);
+  free(soft);
+  correct_convolutional_destroy(packed);
+  correct_convolutional_destroy(scalar);
+}
+
+int main()
+{
+  benchRsEncode();
+  benchViterbi();
+  return 0;
+}
+#endif
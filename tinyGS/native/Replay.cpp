@@ -0,0 +1,190 @@
+/*
+  Replay.cpp - Runs the station on the host, fed by a capture of received frames
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifdef NATIVE_HAL
+#include <Arduino.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "NativeHal.h"
+#include "Sx127xModel.h"
+#include "../src/ConfigManager/ConfigManager.h"
+#include "../src/Mqtt/MQTT_Client.h"
+#include "../src/Radio/Radio.h"
+#include "../src/Radio/Telecommands.h"
+#include "../src/Radio/DataSession.h"
+#include "../src/Orbit/Orbit.h"
+#include "../src/Radio/Doppler.h"
+#include "../src/Logger/Logger.h"
+
+// Global status
+Status status;
+
+static ConfigManager& configManager = ConfigManager::getInstance();
+static MQTT_Client& mqtt = MQTT_Client::getInstance();
+static Radio& radio = Radio::getInstance();
+
+// same work as the main loop of the firmware once it is online
+static void pump(unsigned long ms)
+{
+  unsigned long start = millis();
+  do
+  {
+    while (RxFrame* frame = radio.takeFrame())
+    {
+      mqtt.sendRx(*frame);
+      radio.releaseFrame(frame);
+    }
+    DataSession::getInstance().loop();
+    Orbit::getInstance().loop();
+    Doppler::getInstance().loop();
+    mqtt.loop();
+    delay(1);
+  } while (millis() - start < ms);
+}
+
+static bool parseHex(const std::string& hex, std::vector<uint8_t>& out)
+{
+  if (hex.size() % 2)
+    return false;
+  out.clear();
+  for (size_t i = 0; i < hex.size(); i += 2)
+  {
+    char* end;
+    std::string byte = hex.substr(i, 2);
+    out.push_back(strtoul(byte.c_str(), &end, 16));
+    if (*end)
+      return false;
+  }
+  return true;
+}
+
+// Script lines:
+//   rx <hex payload> [rssi snr frequency_error [crc_error]]
+//   cmnd <command> <payload>     published by the broker on the station command topic
+//   console <command>            typed on the serial console, the telecommands only
+//   broker up|down               the broker accepts or drops the connection
+//   wait <ms>
+// Everything the station publishes is printed prefixed with "MQTT> ", and
+// every frame it transmits prefixed with "RADIO> tx "
+int main(int argc, char** argv)
+{
+  std::ifstream file;
+  if (argc > 1)
+  {
+    file.open(argv[1]);
+    if (!file)
+    {
+      fprintf(stderr, "Unable to open %s\n", argv[1]);
+      return 1;
+    }
+  }
+  std::istream& script = argc > 1 ? file : std::cin;
+
+  Log::console(PSTR("TinyGS Version %d - %s (native replay)"), status.version, status.git_version);
+  configManager.init();
+  board_type board = configManager.getBoardConfig();
+  if (!board.L_SX127X)
+  {
+    Log::console(PSTR("Only SX127x boards are modelled, board %u is not one of them"), configManager.getBoard());
+    return 1;
+  }
+  // commands are routed by user and station, so there has to be one
+  if (!strlen(configManager.getMqttUser()))
+    configManager.setMqttUser("native");
+
+  Sx127xModel sx127x(board.L_DI00);
+  NativeHal::attachSpiDevice(board.L_NSS, &sx127x);
+
+  mqtt.begin();
+  Orbit::getInstance().begin();
+  radio.init();
+  // the first attempt waits for the reconnection interval, as it does after booting on the board
+  unsigned long start = millis();
+  while (!mqtt.connected() && millis() - start < 10000)
+    pump(10);
+
+  std::string line;
+  unsigned int index = 0;
+  while (std::getline(script, line))
+  {
+    std::istringstream words(line);
+    std::string command;
+    if (!(words >> command) || command[0] == '#')
+      continue;
+
+    if (command == "rx")
+    {
+      std::string hex;
+      std::vector<uint8_t> payload;
+      // consecutive frames with the same statistics are taken as duplicates, so defaults vary
+      float rssi = -100.0f - index % 10;
+      float snr = 5.0f;
+      float frequencyError = 0;
+      int crcError = 0;
+      words >> hex >> rssi >> snr >> frequencyError >> crcError;
+      index++;
+      if (!parseHex(hex, payload))
+        Log::console(PSTR("Invalid payload: %s"), hex.c_str());
+      else if (!sx127x.receive(payload, rssi, snr, frequencyError, crcError))
+        Log::console(PSTR("The radio is not listening, frame %u skipped"), index);
+    }
+    else if (command == "cmnd")
+    {
+      std::string name;
+      std::string payload;
+      words >> name;
+      std::getline(words >> std::ws, payload);
+      String topic = String("tinygs/") + configManager.getMqttUser() + "/" + configManager.getThingName() + "/cmnd/" + name.c_str();
+      NativeHal::brokerPublish(topic.c_str(), (const uint8_t*)payload.c_str(), payload.size());
+    }
+    else if (command == "console")
+    {
+      std::string name;
+      words >> name;
+      if (!Telecommands::getInstance().command(name.c_str()))
+        Log::console(PSTR("Unknown command: %s"), name.c_str());
+    }
+    else if (command == "broker")
+    {
+      std::string state;
+      words >> state;
+      NativeHal::setBrokerOnline(state == "up");
+    }
+    else if (command == "wait")
+    {
+      unsigned long ms = 0;
+      words >> ms;
+      pump(ms);
+      continue;
+    }
+    else
+    {
+      Log::console(PSTR("Unknown script command: %s"), command.c_str());
+    }
+    pump(20);
+  }
+
+  // long enough for batches to be flushed and the journal to drain
+  pump(configManager.getRxBatchMs() + 500);
+  fflush(stdout);
+  return 0;
+}
+
+#endif
@@ -23,10 +23,8 @@
 #include "../Mqtt/MQTT_Client.h"
 #include "../Logger/Logger.h"
 #include "../Radio/Radio.h"
+#include "../Radio/Telecommands.h"
 #include "../Display/graphics.h"
-#include "../radio/correct/rs/ecc.h"
-#include "../radio/correct/reed-solomon.h"
-#include "../radio/correct/convolutional.h"
 #include "ArduinoJson.h"
 #if ARDUINOJSON_USE_LONG_LONG == 0 && !PLATFORMIO
 #error "Using Arduino IDE is not recommended, please follow this guide https://github.com/G4lile0/tinyGS/wiki/Arduino-IDE or edit /ArduinoJson/src/ArduinoJson/Configuration.hpp and amend to #define ARDUINOJSON_USE_LONG_LONG 1 around line 68"
@@ -271,152 +269,7 @@ void ConfigManager::handleRefreshConsole()
         }
       }
     }
-    else if (strcmp(svalue.c_str(), "1") == 0)
-    {
-      txTC(radio.RESET_TC," RESET", sizeof(radio.RESET_TC));
-    }
-    else if (strcmp(svalue.c_str(), "2") == 0)
-    {
-      txTC(radio.EXIT_STATE_TC,"EXIT STATE", sizeof(radio.EXIT_STATE_TC));
-    }
-    else if (strcmp(svalue.c_str(), "10") == 0)
-    {
-      if (!getAllowTx())
-        {
-          Log::console(PSTR("Radio transmission is not allowed by config! Check your config on the web panel and make sure transmission is allowed by local regulations"));
-        }
-      else{
-        static long lastTestPacketTime = 0;
-        if (millis() - lastTestPacketTime < 20*1000)
-        {
-          Log::console(PSTR("Please wait a few seconds to send another test packet."));
-        }
-        else
-        {
-          size_t newArraySize = sizeof(radio.TLE_TC_1) + 4;
-          uint8_t concatenatedArray[newArraySize];
-          concatenate_unix(radio.TLE_TC_1, newArraySize,concatenatedArray);
-          uint8_t telecomand_encoded[256];
-          int size = encode(concatenatedArray,  newArraySize, telecomand_encoded);
-          
-          size_t newArraySize2 = sizeof(radio.TLE_TC_2) + 4;
-          uint8_t concatenatedArray2[newArraySize2];
-          concatenate_unix(radio.TLE_TC_2, newArraySize2,concatenatedArray2);
-          uint8_t telecomand_encoded2[256];
-          int size2 = encode(concatenatedArray2,  newArraySize2, telecomand_encoded2);
-          
-          size_t newArraySize3 = sizeof(radio.TLE_TC_3) + 4;
-          uint8_t concatenatedArray3[newArraySize3];
-          concatenate_unix(radio.TLE_TC_3, newArraySize3,concatenatedArray3);
-          uint8_t telecomand_encoded3[256];
-          int size3 = encode(concatenatedArray3,  newArraySize3, telecomand_encoded3);
-                    
-          size_t newArraySize4 = sizeof(radio.TLE_TC_4) + 4;
-          uint8_t concatenatedArray4[newArraySize4];
-          concatenate_unix(radio.TLE_TC_4, newArraySize4,concatenatedArray4);
-          uint8_t telecomand_encoded4[256];
-          int size4 = encode(concatenatedArray4,  newArraySize4, telecomand_encoded4);
-                    
-          size_t newArraySize5 = sizeof(radio.TLE_TC_5) + 4;
-          uint8_t concatenatedArray5[newArraySize5];
-          concatenate_unix(radio.TLE_TC_5, newArraySize5,concatenatedArray5);
-          uint8_t telecomand_encoded5[256];
-          int size5 = encode(concatenatedArray5,  newArraySize5, telecomand_encoded5);
-
-
-          radio.sendTx(telecomand_encoded, size);
-          delay(200);
-          //radio.sendTx(radio.TLE_TC_2, sizeof(radio.TLE_TC_2));
-          radio.sendTx(telecomand_encoded2, size2);
-          delay(200);
-          radio.sendTx(telecomand_encoded3, size3);
-          delay(200);
-          radio.sendTx(telecomand_encoded4, size4);
-          delay(200);
-          radio.sendTx(telecomand_encoded5, size5);
-          lastTestPacketTime = millis();
-          Log::console(PSTR("Sending TLE packets!"));
-          
-          
-        }
-      }
-    }
-    else if (strcmp(svalue.c_str(), "11") == 0)
-    {
-      if (!getAllowTx())
-        {
-          Log::console(PSTR("Radio transmission is not allowed by config! Check your config on the web panel and make sure transmission is allowed by local regulations"));
-        }
-      else{
-        static long lastTestPacketTime = 0;
-        if (millis() - lastTestPacketTime < 20*1000)
-        {
-          Log::console(PSTR("Please wait a few seconds to send another test packet."));
-        }
-        else
-        {
-          size_t newArraySize = sizeof(radio.ADCS_CALIBRATION_TC_1) + 4;
-          uint8_t concatenatedArray[newArraySize];
-          concatenate_unix(radio.ADCS_CALIBRATION_TC_1, newArraySize,concatenatedArray);
-          uint8_t telecomand_encoded[256];
-          int size = encode(concatenatedArray,  newArraySize, telecomand_encoded);
-          
-          size_t newArraySize2 = sizeof(radio.ADCS_CALIBRATION_TC_2) + 4;
-          uint8_t concatenatedArray2[newArraySize2];
-          concatenate_unix(radio.ADCS_CALIBRATION_TC_2, newArraySize2,concatenatedArray2);
-          uint8_t telecomand_encoded2[256];
-          int size2 = encode(concatenatedArray2,  newArraySize2, telecomand_encoded2);
-          
-          size_t newArraySize3 = sizeof(radio.ADCS_CALIBRATION_TC_3) + 4;
-          uint8_t concatenatedArray3[newArraySize3];
-          concatenate_unix(radio.ADCS_CALIBRATION_TC_3, newArraySize3,concatenatedArray3);
-          uint8_t telecomand_encoded3[256];
-          int size3 = encode(concatenatedArray3,  newArraySize3, telecomand_encoded3);
-
-          radio.sendTx(telecomand_encoded, size);
-          delay(500);
-          radio.sendTx(telecomand_encoded2, size2);
-          delay(500);
-          radio.sendTx(telecomand_encoded3, size3);
-          lastTestPacketTime = millis();
-          Log::console(PSTR("Sending ADCS_CALIBRATION packets!"));
-          
-          
-        }
-      }
-    }
-    else if (strcmp(svalue.c_str(), "20") == 0)
-    {
-      send_data = true;
-      txTC(radio.SEND_DATA_TC,"SEND DATA",sizeof(radio.SEND_DATA_TC));
-    }
-    else if (strcmp(svalue.c_str(), "21") == 0)
-    {
-      send_telemetry = true;
-      txTC(radio.SEND_TELEMETRY_TC,"SEND TELEMETRY",sizeof(radio.SEND_TELEMETRY_TC));
-    }
-    else if (strcmp(svalue.c_str(), "22") == 0)
-    {
-      txTC(radio.STOP_SENDING_DATA_TC,"STOP SENDING DATA",sizeof(radio.STOP_SENDING_DATA_TC));
-    }
-    else if (strcmp(svalue.c_str(), "23") == 0)
-    {
-      txTC(radio.CHANGE_TIMEOUT_TC,"CHANGE TIMEOUT",sizeof(radio.CHANGE_TIMEOUT_TC));
-    }
-    else if (strcmp(svalue.c_str(), "30") == 0)
-    {
-      txTC(radio.ACTIVATE_PAYLOAD_TC,"ACTIVATE PAYLOAD",sizeof(radio.ACTIVATE_PAYLOAD_TC));
-    }
-    else if (strcmp(svalue.c_str(), "40") == 0)
-    {
-      send_config = true;
-      txTC(radio.SEND_CONFIG_TC, "SEND CONFIG",sizeof(radio.SEND_CONFIG_TC));
-    }
-    else if (strcmp(svalue.c_str(), "41") == 0)
-    {
-      txTC(radio.UPLINK_CONFIG_TC,"UPLINK CONFIG",sizeof(radio.UPLINK_CONFIG_TC));
-    }
-    else
+    else if (!Telecommands::getInstance().command(svalue.c_str()))
     {
       Log::console(PSTR("%s"), F("Command still not supported in web serial console!"));
     }
@@ -468,166 +321,6 @@ void ConfigManager::handleRefreshConsole()
   server.client().stop();
 }
 
-int ConfigManager::encode(byte* TC,  size_t length, uint8_t* encoded){
-
-    unsigned char codeword[256];
-    unsigned char telecomand[256];
-    initialize_ecc ();
-    srand(time(NULL));   // Initialization, should only be called once.
-    memcpy(telecomand, TC, length);
-    encode_data(telecomand, length, codeword);
-    size_t size = length + NPAR;
-    Log::console(PSTR("Packet reed solomon encoded (%u bytes):"), size);
-    char rs_str[size*3] = "";
-    char buffer_rs[3] = "";
-    for (int i = 0; i < size; i++)
-    {
-      sprintf(buffer_rs , "%02x ", codeword[i]);
-      strcat(rs_str, buffer_rs);
-      if ( i == size - 1)
-        Log::console(PSTR("%s"), rs_str); //print before the buffer is going to loop back
-    }
-
-    codeword[size] = 0xFF;
-    size++;
-    for(int i = 1; ((length + NPAR + i) % (BLOCK_COL_INTER*BLOCK_ROW_INTER)) != 0; i++){
-      codeword[length + NPAR + i] = 0;
-      size++;
-    }
-
-    //INTERLEAVE
-    Radio &radio = Radio::getInstance();
-    radio.deinterleave(codeword, size);
-    Log::console(PSTR("Packet reed solomon encoded and interleaved (%u bytes):"), size);
-    char int_str[size*3] = "";
-    char buffer_int[3] = "";
-    memset(encoded,0,sizeof(encoded));
-    memcpy(encoded, codeword, size);
-    for (int i = 0; i < size; i++)
-    {
-      sprintf(buffer_int , "%02x ", codeword[i]);
-      strcat(int_str, buffer_int);
-      if ( i == size - 1)
-        Log::console(PSTR("%s"), int_str); // print before the buffer is going to loop back
-    }
-
-  
-
-    //ENCODE CONVOLUTIONAL
-    /*
-    uint8_t msg[size];
-    memcpy(msg, codeword, size);
-    //print_word(ML, msg);
-
-    correct_convolutional *conv;
-
-    //create convolutional config
-    conv = correct_convolutional_create(RATE_CON, ORDER_CON, correct_conv_r12_7_polynomial);
-
-    //encode message
-    size_t encoded_len_bits = correct_convolutional_encode(conv,msg,size,conv_encoded);
-    int encoded_len_bytes = ceil(encoded_len_bits/8);
-    
-    Log::console(PSTR("Packet turbo encoded sent(%u bytes):"), encoded_len_bytes);
-    char cc_str[size*2] = "";
-    char buffer_cc[2] = "";
-    for (int i = 0; i < encoded_len_bytes; i++)
-    {
-      sprintf(buffer_cc , "%02x ", conv_encoded[i]);
-      strcat(cc_str, buffer_cc);
-      if ( i == encoded_len_bytes - 1)
-        Log::console(PSTR("%s"), cc_str); // print before the buffer is going to loop back
-    }
-    */
-
-    return size;
-}
-
-void ConfigManager::concatenate_unix(byte* TC,  size_t length, uint8_t* concatenatedArray)
-{
-  
-    time_t currentUnixTime = time(NULL);
-    uint32_t unixTime32 = (uint32_t)currentUnixTime;
-    uint8_t unixTimeArray[4];
-    unixTimeArray[0] = (unixTime32 >> 24) & 0xFF;
-    unixTimeArray[1] = (unixTime32 >> 16) & 0xFF;
-    unixTimeArray[2] = (unixTime32 >> 8) & 0xFF;
-    unixTimeArray[3] = unixTime32 & 0xFF;
-    // Copy elements from unixTimeArray to concatenatedArray
-    for (size_t i = 0; i < length; ++i) {
-        concatenatedArray[i] = TC[i];
-    }
-    // Copy elements from otherArray to concatenatedArray
-    for (size_t i = 0; i < 4; ++i) {
-        concatenatedArray[length + i] = unixTimeArray[i];
-    }
-}
-
-void ConfigManager::txTC(byte* TC, const char* TC_name,  size_t length)
-{
-
-  if (!getAllowTx())
-  {
-    Log::console(PSTR("Radio transmission is not allowed by config! Check your config on the web panel and make sure transmission is allowed by local regulations"));
-  }
-
-  else
-  {
-    size_t newArraySize = length + 4;
-    uint8_t concatenatedArray[newArraySize];
-    concatenate_unix(TC, length,concatenatedArray);
-
-    /*
-    time_t currentUnixTime = time(NULL);
-    uint32_t unixTime32 = (uint32_t)currentUnixTime;
-    uint8_t unixTimeArray[4];
-    unixTimeArray[0] = (unixTime32 >> 24) & 0xFF;
-    unixTimeArray[1] = (unixTime32 >> 16) & 0xFF;
-    unixTimeArray[2] = (unixTime32 >> 8) & 0xFF;
-    unixTimeArray[3] = unixTime32 & 0xFF;
-    size_t unixTimeSize = sizeof(unixTimeArray);
-    size_t TCSize = length;
-    size_t newArraySize = unixTimeSize + TCSize;
-    uint8_t concatenatedArray[newArraySize];
-    // Copy elements from unixTimeArray to concatenatedArray
-    for (size_t i = 0; i < TCSize; ++i) {
-        concatenatedArray[i] = TC[i];
-    }
-    // Copy elements from otherArray to concatenatedArray
-    for (size_t i = 0; i < unixTimeSize; ++i) {
-        concatenatedArray[TCSize + i] = unixTimeArray[i];
-    }
-    */
-
-    Radio &radio = Radio::getInstance();
-    uint8_t telecomand_encoded[256];
-    int size = encode(concatenatedArray,  newArraySize, telecomand_encoded);
-
-    static long lastPacketTime = 0;
-    if (millis() - lastPacketTime < 20*1000)
-    {
-      Log::console(PSTR("Please wait a few seconds to send another test packet."));
-    }     
-
-    else
-    {
-      radio.sendTx(telecomand_encoded, size);
-      lastPacketTime = millis();
-      Log::console(PSTR("Sending %s TC packet!") ,TC_name);
-
-      char rs_str[size*2] = "";
-      char buffer_rs[2] = "";
-      for (int i = 0; i < size; i++)
-      {
-        sprintf(buffer_rs , "%02x ", telecomand_encoded[i]);
-        strcat(rs_str, buffer_rs);
-        if ( i == size - 1)
-          Log::console(PSTR("%s"), rs_str); //print before the buffer is going to loop back
-      }
-
-    }
-  }
-}
 void ConfigManager::handleRefreshWorldmap()
 {
   if (getState() == IOTWEBCONF_STATE_ONLINE)
@@ -921,6 +614,31 @@ void ConfigManager::parseAdvancedConf()
   {
     advancedConf.lowPower = doc["lowPower"];
   }
+
+  if (doc.containsKey(F("rxPack")))
+  {
+    advancedConf.rxMsgPack = doc["rxPack"];
+  }
+
+  if (doc.containsKey(F("rxBatch")))
+  {
+    advancedConf.rxBatchMs = doc["rxBatch"];
+  }
+
+  if (doc.containsKey(F("arqWin")))
+  {
+    advancedConf.arqWindow = doc["arqWin"];
+  }
+
+  if (doc.containsKey(F("arqTo")))
+  {
+    advancedConf.arqTimeoutMs = doc["arqTo"];
+  }
+
+  if (doc.containsKey(F("minEl")))
+  {
+    advancedConf.minElevation = doc["minEl"];
+  }
 }
 
 void ConfigManager::parseModemStartup()
@@ -983,7 +701,33 @@ void ConfigManager::parseModemStartup()
       status.modeminfo.filter[i] = 0;
   }
 
+  parseFecConfig(doc.as<JsonVariantConst>());
+
   if (Radio::getInstance().isReady())
     Radio::getInstance().begin();
 }
 
+// FEC chain of the modem config, shared with the begine MQTT command
+void ConfigManager::parseFecConfig(JsonVariantConst doc)
+{
+  RadioLock lock; // the TC framing reads it, the FEC task works on the copy begin() takes
+  ModemInfo &m = status.modeminfo;
+
+  // "rs": "ccsds" for RS(255,223), parity bytes of the shortened code, or 0 to disable.
+  // The RS workspace is sized for MIN_DISTANCE_RS parity bytes
+  JsonVariantConst rs = doc["rs"];
+  m.rsCcsds = rs == "ccsds";
+  m.rsParity = m.rsCcsds ? MIN_DISTANCE_RS : NPAR;
+  if (rs.is<long>() && rs.as<long>() >= 0 && rs.as<long>() <= (long)MIN_DISTANCE_RS)
+    m.rsParity = rs.as<long>();
+  else if (!rs.isNull() && !m.rsCcsds)
+    Log::console(PSTR("Invalid FEC config rs: %s, using %u parity bytes"), rs.as<String>().c_str(), NPAR);
+  // "conv": true when the frame is convolutionally encoded after interleaving
+  m.conv = doc["conv"] | false;
+  // "il": interleaver depth, 4 (4x4 blocks, the default), 8 or 16
+  uint8_t depth = doc["il"] | BLOCK_ROW_INTER;
+  m.interleaverDepth = (depth == 8 || depth == 16) ? depth : BLOCK_ROW_INTER;
+  // "hdr": true when the codeword is framed by a length header instead of the 0xFF marker
+  m.lengthHeader = doc["hdr"] | false;
+}
+
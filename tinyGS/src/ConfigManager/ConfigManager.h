@@ -26,6 +26,7 @@
 #include "logos.h"
 #include <Wire.h>
 #include "html.h"
+#include "ArduinoJson.h"
 
 #ifdef ESP8266
 #include "ESP8266HTTPUpdateServer.h"
@@ -115,6 +116,11 @@ typedef struct
   bool flipOled = true;
   bool dnOled = true;
   bool lowPower = false;
+  bool rxMsgPack = false;      // publish received frames as batched MessagePack
+  uint16_t rxBatchMs = 1000;   // longest a frame waits in a batch, 0 publishes every frame
+  uint8_t arqWindow = 20;      // frames of a SEND DATA transfer
+  uint16_t arqTimeoutMs = 15000; // silence that ends a SEND DATA round
+  uint8_t minElevation = 5;    // deg, no TX below it once the orbit is known
 } AdvancedConfig;
 
 class ConfigManager : public IotWebConf2
@@ -130,13 +136,16 @@ public:
   void resetModemConfig();
   boolean init();
   void printConfig();
-  void txTC(uint8_t* TC, const char* TC_name,  size_t length);
-  void concatenate_unix(byte* TC,  size_t length, uint8_t* concatenated);
-  int encode(byte* TC,  size_t length, uint8_t* encoded);
+  void parseFecConfig(JsonVariantConst doc);
   
   uint16_t getMqttPort() { return (uint16_t)atoi(mqttPort); }
   const char *getMqttServer() { return mqttServer; }
   const char *getMqttUser() { return mqttUser; }
+  void setMqttUser(const char *user)
+  {
+    strlcpy(mqttUser, user, sizeof(mqttUser));
+    this->saveConfig();
+  }
   const char *getMqttPass() { return mqttPass; }
   float getLatitude() { return atof(latitude); }
   float getLongitude() { return atof(longitude); }
@@ -215,6 +224,11 @@ public:
   bool getFlipOled() { return advancedConf.flipOled; }
   bool getDayNightOled() { return advancedConf.dnOled; }
   bool getLowPower() { return advancedConf.lowPower; }
+  bool getRxMsgPack() { return advancedConf.rxMsgPack; }
+  uint16_t getRxBatchMs() { return advancedConf.rxBatchMs; }
+  uint8_t getArqWindow() { return advancedConf.arqWindow; }
+  uint16_t getArqTimeoutMs() { return advancedConf.arqTimeoutMs; }
+  uint8_t getMinElevation() { return advancedConf.minElevation; }
   void saveConfig()
   {
     remoteSave = true;
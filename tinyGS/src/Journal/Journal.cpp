@@ -0,0 +1,275 @@
+/*
+  Journal.cpp - Flash journal of the frames received while MQTT is down
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Journal.h"
+#include "../Logger/Logger.h"
+#include <rom/crc.h>
+
+void Journal::begin()
+{
+  partition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_DATA_SPIFFS, NULL);
+  if (!partition || partition->size < 2 * SECTOR_SIZE)
+  {
+    Log::console(PSTR("No data partition for the journal, frames received while offline will be lost"));
+    partition = nullptr;
+    return;
+  }
+  sectors = partition->size / SECTOR_SIZE > MAX_SECTORS ? MAX_SECTORS : partition->size / SECTOR_SIZE;
+
+  // the newest sector is where appending continues
+  bool found = false;
+  SectorHeader sh;
+  for (uint16_t s = 0; s < sectors; s++)
+  {
+    esp_partition_read(partition, sectorAddress(s), &sh, sizeof(sh));
+    if (sh.magic == MAGIC && (!found || sh.seq > headSeq))
+    {
+      found = true;
+      headSeq = sh.seq;
+      headSector = s;
+    }
+  }
+
+  if (!found)
+  {
+    openSector(0, 1);
+    replaySector = headSector;
+    replayOffset = headOffset;
+    Log::console(PSTR("Journal initialized, %u sectors"), sectors);
+    return;
+  }
+
+  // sectors are written in ring order, so the oldest one is the first valid after the head
+  uint16_t s = headSector;
+  for (uint16_t k = 1; k < sectors; k++)
+  {
+    uint16_t candidate = (headSector + k) % sectors;
+    esp_partition_read(partition, sectorAddress(candidate), &sh, sizeof(sh));
+    if (sh.magic == MAGIC)
+    {
+      s = candidate;
+      break;
+    }
+  }
+
+  // walk every record up to the head, counting what was never published
+  bool replayFound = false;
+  RecordHeader rec;
+  while (true)
+  {
+    uint32_t offset = sizeof(SectorHeader);
+    while (readRecord(s, offset, rec))
+    {
+      if (rec.replayed == 0xFF)
+      {
+        if (!replayFound)
+        {
+          replayFound = true;
+          replaySector = s;
+          replayOffset = offset;
+        }
+        status.journal.pending++;
+      }
+      offset += recordStride(rec.length);
+    }
+
+    if (s == headSector)
+    {
+      headOffset = offset;
+      break;
+    }
+    s = (s + 1) % sectors;
+  }
+
+  if (!replayFound)
+  {
+    replaySector = headSector;
+    replayOffset = headOffset;
+  }
+
+  Log::console(PSTR("Journal mounted, %u frames waiting to be published"), status.journal.pending);
+}
+
+bool Journal::append(const RxFrame& frame)
+{
+  if (!partition)
+    return false;
+
+  uint16_t length = frame.crc_error ? 0 : frame.length;
+  uint32_t stride = recordStride(length);
+
+  if (headOffset + stride > SECTOR_SIZE)
+  {
+    uint16_t next = (headSector + 1) % sectors;
+    if (status.journal.pending && replaySector == next)
+    {
+      // the ring is full, the oldest sector is overwritten with whatever is still pending in it
+      RecordHeader rec;
+      while (readRecord(replaySector, replayOffset, rec))
+      {
+        if (rec.replayed == 0xFF)
+        {
+          status.journal.lost++;
+          status.journal.pending--;
+        }
+        replayOffset += recordStride(rec.length);
+      }
+      replaySector = (next + 1) % sectors;
+      replayOffset = sizeof(SectorHeader);
+    }
+
+    if (!openSector(next, headSeq + 1))
+      return false;
+  }
+
+  if (!status.journal.pending)
+  {
+    replaySector = headSector;
+    replayOffset = headOffset;
+  }
+
+  uint8_t record[sizeof(RecordHeader) + sizeof(frame.data)];
+  RecordHeader& rec = *(RecordHeader*)record;
+  memset(record, 0xFF, stride);
+  rec.length = length;
+  rec.replayed = 0xFF;
+  rec.flags = (frame.crc_error ? FLAG_CRC_ERROR : 0) | (frame.noisy ? FLAG_NOISY : 0);
+  rec.irqUnixUsec = frame.irqUnixUsec;
+  rec.rssi = frame.rssi;
+  rec.snr = frame.snr;
+  rec.frequencyerror = frame.frequencyerror;
+  rec.rs_corrected = frame.rs_corrected;
+  rec.reserved = 0xFFFF;
+  memcpy(record + sizeof(RecordHeader), frame.data, length);
+  rec.checksum = checksum(rec, frame.data);
+
+  if (esp_partition_write(partition, sectorAddress(headSector) + headOffset, record, stride) != ESP_OK)
+  {
+    Log::error(PSTR("Journal write failed"));
+    return false;
+  }
+
+  headOffset += stride;
+  status.journal.stored++;
+  status.journal.pending++;
+  return true;
+}
+
+// Reads the oldest frame not published yet, it stays pending until markReplayed()
+bool Journal::peek(RxFrame& frame)
+{
+  RecordHeader rec;
+  while (status.journal.pending)
+  {
+    if (!readRecord(replaySector, replayOffset, rec))
+    {
+      if (replaySector == headSector)
+      {
+        status.journal.pending = 0;
+        return false;
+      }
+      replaySector = (replaySector + 1) % sectors;
+      replayOffset = sizeof(SectorHeader);
+      continue;
+    }
+
+    if (rec.replayed != 0xFF)
+    {
+      replayOffset += recordStride(rec.length);
+      continue;
+    }
+
+    if (rec.length <= sizeof(frame.data))
+      esp_partition_read(partition, sectorAddress(replaySector) + replayOffset + sizeof(RecordHeader), frame.data, rec.length);
+    if (rec.length > sizeof(frame.data) || checksum(rec, frame.data) != rec.checksum)
+    {
+      // torn by a power loss while it was written
+      status.journal.lost++;
+      clearRecord(rec.length);
+      continue;
+    }
+
+    frame.length = rec.length;
+    frame.state = 0;
+    frame.rssi = rec.rssi;
+    frame.snr = rec.snr;
+    frame.frequencyerror = rec.frequencyerror;
+    frame.noisy = rec.flags & FLAG_NOISY;
+    frame.crc_error = rec.flags & FLAG_CRC_ERROR;
+    frame.rs_corrected = rec.rs_corrected;
+    frame.irqTime = 0;
+    frame.irqUnixUsec = rec.irqUnixUsec;
+    return true;
+  }
+
+  return false;
+}
+
+void Journal::markReplayed()
+{
+  RecordHeader rec;
+  if (!status.journal.pending || !readRecord(replaySector, replayOffset, rec))
+    return;
+
+  clearRecord(rec.length);
+  status.journal.replayed++;
+}
+
+// flags the record at the replay position as done, without erasing anything
+void Journal::clearRecord(uint16_t length)
+{
+  uint8_t replayed = 0;
+  esp_partition_write(partition, sectorAddress(replaySector) + replayOffset + offsetof(RecordHeader, replayed), &replayed, 1);
+  replayOffset += recordStride(length);
+  status.journal.pending--;
+}
+
+bool Journal::readRecord(uint16_t sector, uint32_t offset, RecordHeader& header)
+{
+  if (offset + sizeof(RecordHeader) > SECTOR_SIZE)
+    return false;
+  esp_partition_read(partition, sectorAddress(sector) + offset, &header, sizeof(header));
+  return header.length != 0xFFFF && offset + recordStride(header.length) <= SECTOR_SIZE;
+}
+
+// covers the whole record except the bytes changed after it is written
+uint32_t Journal::checksum(const RecordHeader& header, const uint8_t* data)
+{
+  RecordHeader copy = header;
+  copy.replayed = 0xFF;
+  copy.checksum = 0;
+  uint32_t crc = crc32_le(0, (const uint8_t*)&copy, sizeof(copy));
+  return crc32_le(crc, data, header.length);
+}
+
+bool Journal::openSector(uint16_t sector, uint32_t seq)
+{
+  if (esp_partition_erase_range(partition, sectorAddress(sector), SECTOR_SIZE) != ESP_OK)
+  {
+    Log::error(PSTR("Journal erase failed"));
+    return false;
+  }
+
+  SectorHeader header = {MAGIC, seq};
+  esp_partition_write(partition, sectorAddress(sector), &header, sizeof(header));
+  headSeq = seq;
+  headSector = sector;
+  headOffset = sizeof(SectorHeader);
+  return true;
+}
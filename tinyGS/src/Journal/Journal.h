@@ -0,0 +1,89 @@
+/*
+  Journal.h - Flash journal of the frames received while MQTT is down
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <Arduino.h>
+#include <esp_partition.h>
+#include "../Status.h"
+
+extern Status status;
+
+// Append-only ring of sectors in the data partition the default partition
+// table reserves for SPIFFS, which the firmware does not otherwise use.
+// Sectors are filled in order and only erased when the ring wraps onto them,
+// so every sector wears at the same rate. Each sector starts with a sequence
+// number, which is how the write and replay positions are found again after a
+// restart. Records are marked replayed in place by clearing one byte.
+class Journal {
+public:
+  static Journal& getInstance()
+  {
+    static Journal instance;
+    return instance;
+  }
+  void begin();
+  bool append(const RxFrame& frame);
+  bool peek(RxFrame& frame);
+  void markReplayed();
+  bool pending() { return status.journal.pending > 0; }
+
+private:
+  Journal() {};
+  struct SectorHeader {
+    uint32_t magic;
+    uint32_t seq;
+  };
+  struct RecordHeader {
+    uint16_t length;     // payload bytes, 0xFFFF where the sector has not been written yet
+    uint8_t replayed;    // 0xFF pending, cleared once published
+    uint8_t flags;
+    uint32_t checksum;
+    int64_t irqUnixUsec;
+    float rssi;
+    float snr;
+    float frequencyerror;
+    int16_t rs_corrected;
+    uint16_t reserved;
+  };
+
+  static uint32_t recordStride(uint16_t length) { return sizeof(RecordHeader) + ((length + 3) & ~3); }
+  uint32_t sectorAddress(uint16_t sector) { return (uint32_t)sector * SECTOR_SIZE; }
+  bool readRecord(uint16_t sector, uint32_t offset, RecordHeader& header);
+  uint32_t checksum(const RecordHeader& header, const uint8_t* data);
+  bool openSector(uint16_t sector, uint32_t seq);
+  void clearRecord(uint16_t length);
+
+  static const uint32_t MAGIC = 0x4A534754;   // "TGSJ"
+  static const uint32_t SECTOR_SIZE = 4096;
+  static const uint16_t MAX_SECTORS = 64;     // 256 KB, the rest of the partition stays untouched
+  static const uint8_t FLAG_CRC_ERROR = 0x01;
+  static const uint8_t FLAG_NOISY = 0x02;
+
+  const esp_partition_t* partition = nullptr;
+  uint16_t sectors = 0;
+  uint32_t headSeq = 0;
+  uint16_t headSector = 0;     // sector being appended to
+  uint32_t headOffset = 0;
+  uint16_t replaySector = 0;   // oldest record not published yet
+  uint32_t replayOffset = 0;
+};
+
+#endif
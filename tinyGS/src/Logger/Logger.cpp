@@ -22,6 +22,7 @@
 char Log::logIdx = 1;
 Log::LoggingLevels Log::logLevel = LOG_LEVEL;
 char Log::log[MAX_LOG_SIZE] = "";
+SemaphoreHandle_t Log::logMutex = xSemaphoreCreateMutex();
 
 void Log::console(const char* formatP, ...)
 {
@@ -79,6 +80,7 @@ void Log::AddLog(Log::LoggingLevels level, const char* logData)
       timeStr[0] = '\0';
   }
   
+  xSemaphoreTake(logMutex, portMAX_DELAY);
   Serial.printf (PSTR ("%s%s\n"), timeStr, logData);
 
   // Delimited, zero-terminated buffer of log lines.
@@ -98,6 +100,7 @@ void Log::AddLog(Log::LoggingLevels level, const char* logData)
   logIdx &= 0xFF;
   if (!logIdx) 
     logIdx++;       // Index 0 is not allowed as it is the end of char string*/
+  xSemaphoreGive(logMutex);
 }
 
 void Log::getLog(uint32_t idx, char** entry_pp, size_t* len_p)
@@ -39,4 +39,5 @@ private:
   static char log[MAX_LOG_SIZE];
   static char logIdx;
   static LoggingLevels logLevel;
+  static SemaphoreHandle_t logMutex;  // the radio tasks and the network task log from both cores
 };
@@ -25,6 +25,9 @@
 #include "../Radio/Radio.h"
 #include "../OTA/OTA.h"
 #include "../Logger/Logger.h"
+#include "../Journal/Journal.h"
+#include "../Orbit/Orbit.h"
+#include <mbedtls/base64.h>
 
 MQTT_Client::MQTT_Client()
     : PubSubClient(espClient)
@@ -63,6 +66,23 @@ void MQTT_Client::loop()
   PubSubClient::loop();
 
   unsigned long now = millis();
+  if (!rxBatch.empty() && now - rxBatchStart >= ConfigManager::getInstance().getRxBatchMs())
+    flushRx();
+
+  // frames stored while offline go out oldest first, a few at a time so live traffic keeps flowing
+  Journal &journal = Journal::getInstance();
+  if (journal.pending() && connected() && now - lastReplay > replayInterval)
+  {
+    lastReplay = now;
+    RxFrame frame;
+    if (journal.peek(frame) && replayRx(frame))
+    {
+      journal.markReplayed();
+      if (!journal.pending())
+        Log::console(PSTR("Journal replay finished, %u frames published"), status.journal.replayed);
+    }
+  }
+
   if (now - lastPing > pingInterval && connected())
   {
     lastPing = now;
@@ -145,6 +165,10 @@ void MQTT_Client::sendWelcome()
 {
   scheduledRestart = false;
   ConfigManager &configManager = ConfigManager::getInstance();
+  // the rx topic is built once per connection instead of once per packet
+  rxMsgPack = configManager.getRxMsgPack();
+  rxBatch.clear();
+  strlcpy(rxTopic, buildTopic(teleTopic, rxMsgPack ? topicRxPack : topicRx).c_str(), sizeof(rxTopic));
   time_t now;
   time(&now);
 
@@ -152,7 +176,7 @@ void MQTT_Client::sendWelcome()
   char clientId[13];
   sprintf(clientId, "%04X%08X", (uint16_t)(chipId >> 32), (uint32_t)chipId);
 
-  const size_t capacity = JSON_ARRAY_SIZE(2) + JSON_OBJECT_SIZE(17) + 22 + 20 + 20;
+  const size_t capacity = JSON_ARRAY_SIZE(2) + JSON_OBJECT_SIZE(18) + 22 + 20 + 20;
   DynamicJsonDocument doc(capacity);
   JsonArray station_location = doc.createNestedArray("station_location");
   station_location.add(configManager.getLatitude());
@@ -174,22 +198,131 @@ void MQTT_Client::sendWelcome()
   doc["Mem"] = ESP.getFreeHeap();
   doc["board"] = configManager.getBoard();
   doc["mac"] = clientId;
+  if (rxMsgPack)
+    doc["rx_fmt"] = "msgpack";
 
   char buffer[1048];
   serializeJson(doc, buffer);
   publish(buildTopic(teleTopic, topicWelcome).c_str(), buffer, false);
 }
 
-void MQTT_Client::sendRx(String packet, bool noisy)
+void MQTT_Client::sendRx(const RxFrame& frame)
+{
+  // publishing on a dead connection would lose the frame, it waits in flash instead
+  if (!connected())
+  {
+    Journal::getInstance().append(frame);
+    return;
+  }
+
+  if (rxMsgPack)
+    batchRx(frame);
+  else if (!sendRxJson(frame))
+    Journal::getInstance().append(frame);
+}
+
+// A journal record is published on its own and only marked replayed once the
+// broker took it. It is not written back on failure, it is still in the journal
+bool MQTT_Client::replayRx(const RxFrame& frame)
 {
+  if (!rxMsgPack)
+    return sendRxJson(frame);
+
+  flushRx();
+  if (!openRxBatch() || !rxBatch.add(frame))
+  {
+    Log::error(PSTR("Frame does not fit an rx batch, dropped"));
+    rxBatch.clear();
+    return true; // it never will, the journal moves on
+  }
+  bool sent = publish(rxTopic, rxBatch.data(), rxBatch.size(), false);
+  rxBatch.clear();
+  return sent;
+}
+
+// The modem settings shared by every frame of the batch
+bool MQTT_Client::openRxBatch()
+{
+  StaticJsonDocument<JSON_OBJECT_SIZE(8)> header;
+  header["mode"] = status.modeminfo.modem_mode.c_str();
+  header["frequency"] = status.modeminfo.frequency;
+  header["frequency_offset"] = status.modeminfo.freqOffset;
+  header["satellite"] = (const char*)status.modeminfo.satellite;
+  header["NORAD"] = status.modeminfo.NORAD;
+  if (status.modeminfo.modem_mode == "LoRa")
+  {
+    header["sf"] = status.modeminfo.sf;
+    header["cr"] = status.modeminfo.cr;
+    header["bw"] = status.modeminfo.bw;
+  }
+  else
+  {
+    header["bitrate"] = status.modeminfo.bitrate;
+    header["freqdev"] = status.modeminfo.freqDev;
+    header["rxBw"] = status.modeminfo.bw;
+  }
+  return rxBatch.open(header);
+}
+
+// Frames received close together share one publish, the batch goes out when
+// it is full or when its oldest frame has waited for the configured deadline
+void MQTT_Client::batchRx(const RxFrame& frame)
+{
+  if (rxBatch.empty() || !rxBatch.add(frame))
+  {
+    flushRx();
+    if (!openRxBatch() || !rxBatch.add(frame))
+    {
+      Log::error(PSTR("Frame does not fit an rx batch, dropped"));
+      rxBatch.clear();
+      return;
+    }
+    rxBatchStart = millis();
+  }
+
+  if (rxBatch.full() || !ConfigManager::getInstance().getRxBatchMs())
+    flushRx();
+}
+
+// The frames of a batch the broker did not take wait in the journal, like the
+// ones received while offline
+bool MQTT_Client::flushRx()
+{
+  if (rxBatch.empty())
+    return true;
+
+  Log::debug(PSTR("Publishing rx batch (%u bytes)"), rxBatch.size());
+  bool sent = connected() && publish(rxTopic, rxBatch.data(), rxBatch.size(), false);
+  if (!sent)
+  {
+    RxFrame frame;
+    for (uint8_t i = 0; rxBatch.get(i, frame); i++)
+      Journal::getInstance().append(frame);
+    Log::console(PSTR("Rx batch not published, %u frames kept in the journal"), rxBatch.count());
+  }
+  rxBatch.clear();
+  return sent;
+}
+
+// Runs for every packet, so everything lives on the stack: no String, no heap document
+bool MQTT_Client::sendRxJson(const RxFrame& frame)
+{
+  static const char crcError[] = "Error_CRC";
+  char packet[(sizeof(frame.data) + 2) / 3 * 4 + 1];
+  size_t packetLen = 0;
+  if (frame.crc_error)
+    mbedtls_base64_encode((unsigned char*)packet, sizeof(packet), &packetLen, (const unsigned char*)crcError, sizeof(crcError) - 1);
+  else
+    mbedtls_base64_encode((unsigned char*)packet, sizeof(packet), &packetLen, frame.data, frame.length);
+  packet[packetLen] = '\0';
   ConfigManager &configManager = ConfigManager::getInstance();
   time_t now;
   time(&now);
   struct timeval tv;
   gettimeofday(&tv, NULL);
 
-  const size_t capacity = JSON_ARRAY_SIZE(2) + JSON_OBJECT_SIZE(23) + 25;
-  DynamicJsonDocument doc(capacity);
+  const size_t capacity = JSON_ARRAY_SIZE(2) + JSON_OBJECT_SIZE(25) + 25;
+  StaticJsonDocument<capacity> doc;
   JsonArray station_location = doc.createNestedArray("station_location");
   station_location.add(configManager.getLatitude());
   station_location.add(configManager.getLongitude());
@@ -198,7 +331,7 @@ void MQTT_Client::sendRx(String packet, bool noisy)
   doc["frequency_offset"] = status.modeminfo.freqOffset;
   doc["satellite"] = status.modeminfo.satellite;
 
-  if (String(status.modeminfo.modem_mode) == "LoRa")
+  if (status.modeminfo.modem_mode == "LoRa")
   {
     doc["sf"] = status.modeminfo.sf;
     doc["cr"] = status.modeminfo.cr;
@@ -211,22 +344,24 @@ void MQTT_Client::sendRx(String packet, bool noisy)
     doc["rxBw"] = status.modeminfo.bw;
   }
 
-  doc["rssi"] = status.lastPacketInfo.rssi;
-  doc["snr"] = status.lastPacketInfo.snr;
-  doc["frequency_error"] = status.lastPacketInfo.frequencyerror;
+  doc["rssi"] = frame.rssi;
+  doc["snr"] = frame.snr;
+  doc["frequency_error"] = frame.frequencyerror;
   doc["unix_GS_time"] = now;
   doc["usec_time"] = (int64_t)tv.tv_usec + tv.tv_sec * 1000000ll;
+  doc["rx_usec_time"] = frame.irqUnixUsec; // when the DIO interrupt fired, for time of arrival
   doc["time_offset"] = status.time_offset;
-  doc["crc_error"] = status.lastPacketInfo.crc_error;
-  doc["data"] = packet.c_str();
+  doc["crc_error"] = frame.crc_error;
+  doc["rs_corrected"] = frame.rs_corrected;
+  doc["data"] = (const char*)packet;
   doc["NORAD"] = status.modeminfo.NORAD;
   doc["test"] = configManager.getTestMode();
-  doc["noisy"] = noisy;
+  doc["noisy"] = frame.noisy;
 
   char buffer[1536];
   serializeJson(doc, buffer);
   Log::debug(PSTR("%s"), buffer);
-  publish(buildTopic(teleTopic, topicRx).c_str(), buffer, false);
+  return publish(rxTopic, buffer, false);
 }
 
 void MQTT_Client::sendStatus()
@@ -236,7 +371,7 @@ void MQTT_Client::sendStatus()
   time(&now);
   struct timeval tv;
   gettimeofday(&tv, NULL);
-  const size_t capacity = JSON_ARRAY_SIZE(2) + JSON_OBJECT_SIZE(29) + 25;
+  const size_t capacity = JSON_ARRAY_SIZE(2) + JSON_OBJECT_SIZE(43) + 25;
   DynamicJsonDocument doc(capacity);
   JsonArray station_location = doc.createNestedArray("station_location");
   station_location.add(configManager.getLatitude());
@@ -277,6 +412,19 @@ void MQTT_Client::sendStatus()
   doc["snr"] = status.lastPacketInfo.snr;
   doc["frequency_error"] = status.lastPacketInfo.frequencyerror;
   doc["crc_error"] = status.lastPacketInfo.crc_error;
+  doc["rs_clean"] = status.fecStats.rsClean;
+  doc["rs_fixed"] = status.fecStats.rsCorrected;
+  doc["rs_failed"] = status.fecStats.rsFailed;
+  doc["rx_cycles"] = status.fecStats.rxCyclesMax;
+  doc["rx_dropped"] = status.rxQueue.reportsDropped;
+  doc["rx_pool_exhausted"] = status.rxQueue.poolExhausted;
+  doc["rx_queue_max"] = status.rxQueue.depthMax;
+  doc["report_queue_max"] = status.rxQueue.reportDepthMax;
+  doc["rx_latency"] = status.rxQueue.latency;
+  doc["rx_latency_max"] = status.rxQueue.latencyMax;
+  doc["journal_pending"] = status.journal.pending;
+  doc["journal_replayed"] = status.journal.replayed;
+  doc["journal_lost"] = status.journal.lost;
   doc["unix_GS_time"] = now;
   doc["usec_time"] = (int64_t)tv.tv_usec + tv.tv_sec * 1000000ll;
   doc["time_offset"] = status.time_offset;
@@ -300,6 +448,8 @@ void MQTT_Client::sendAdvParameters()
 void MQTT_Client::manageMQTTData(char *topic, uint8_t *payload, unsigned int length)
 {
   Radio &radio = Radio::getInstance();
+  // a command may retune the radio, frames already batched keep the settings they were received with
+  flushRx();
 
   bool global = true;
   char *command;
@@ -319,6 +469,10 @@ void MQTT_Client::manageMQTTData(char *topic, uint8_t *payload, unsigned int len
     return; // no ack
   }
 
+  // ["1 46494U ...", "2 46494 ..."]
+  if (!strcmp(command, commandTle))
+    result = remoteTle((char *)payload, length) ? 0 : 1;
+
   if (!strcmp(command, commandReset))
     ESP.restart();
 
@@ -486,6 +640,8 @@ void MQTT_Client::manageMQTTData(char *topic, uint8_t *payload, unsigned int len
         status.modeminfo.filter[i] = 0;
     }
 
+    ConfigManager::getInstance().parseFecConfig(doc.as<JsonVariantConst>());
+
     radio.begin();
     result = 0;
   }
@@ -691,12 +847,22 @@ void MQTT_Client::manageMQTTData(char *topic, uint8_t *payload, unsigned int len
 
 void MQTT_Client::manageSatPosOled(char *payload, size_t payload_len)
 {
+  if (Orbit::getInstance().valid())
+    return; // propagated locally
   DynamicJsonDocument doc(60);
   deserializeJson(doc, payload, payload_len);
   status.satPos[0] = doc[0];
   status.satPos[1] = doc[1];
 }
 
+bool MQTT_Client::remoteTle(char *payload, size_t payload_len)
+{
+  DynamicJsonDocument doc(256);
+  if (deserializeJson(doc, payload, payload_len) != DeserializationError::Ok || doc.size() != 2)
+    return false;
+  return Orbit::getInstance().setTle(doc[0], doc[1]);
+}
+
 void MQTT_Client::remoteSatCmnd(char *payload, size_t payload_len)
 {
   DynamicJsonDocument doc(256);
@@ -795,4 +961,5 @@ void MQTT_Client::begin()
   ConfigManager &configManager = ConfigManager::getInstance();
   setServer(configManager.getMqttServer(), configManager.getMqttPort());
   setCallback(manageMQTTDataCallback);
+  Journal::getInstance().begin();
 }
@@ -26,6 +26,7 @@
 #include "../ConfigManager/ConfigManager.h"
 #include "../Status.h"
 #include <PubSubClient.h>
+#include "RxBatch.h"
 #if MQTT_MAX_PACKET_SIZE != 1000  && !PLATFORMIO
 #error "Using Arduino IDE is not recommended, please follow this guide https://github.com/G4lile0/tinyGS/wiki/Arduino-IDE or edit /PubSubClient/src/PubSubClient.h  and set #define MQTT_MAX_PACKET_SIZE 1000"
 #endif
@@ -48,7 +49,7 @@ public:
   void begin();
   void loop();
   void sendWelcome();
-  void sendRx(String packet, bool noisy);
+  void sendRx(const RxFrame& frame);
   void manageMQTTData(char *topic, uint8_t *payload, unsigned int length);
   void sendStatus();
   void sendAdvParameters();
@@ -66,7 +67,13 @@ private:
   MQTT_Client();
   String buildTopic(const char * baseTopic, const char * cmnd);
   void subscribeToAll();
+  bool sendRxJson(const RxFrame& frame);
+  bool replayRx(const RxFrame& frame);
+  bool openRxBatch();
+  void batchRx(const RxFrame& frame);
+  bool flushRx();
   void manageSatPosOled(char* payload, size_t payload_len);
+  bool remoteTle(char* payload, size_t payload_len);
   void remoteSatCmnd(char* payload, size_t payload_len);
   void remoteSatFilter(char* payload, size_t payload_len);
   void remoteGoToSleep(char* payload, size_t payload_len);
@@ -74,12 +81,14 @@ private:
 
   bool usingNewCert = false;
   unsigned long lastPing = 0;
+  unsigned long lastReplay = 0;
   unsigned long lastConnectionAtempt = 0;
   uint8_t connectionAtempts = 0;
   bool scheduledRestart = false;
 
   const unsigned long pingInterval = 1 * 60 * 1000;
   const unsigned long reconnectionInterval = 5 * 1000;
+  const unsigned long replayInterval = 200;
   uint16_t connectionTimeout = 5 * 60 * 1000 / reconnectionInterval;
 
   const char* globalTopic PROGMEM = "tinygs/global/%cmnd%";
@@ -92,12 +101,19 @@ private:
   const char* topicPing PROGMEM= "ping";
   const char* topicStatus PROGMEM = "status";
   const char* topicRx PROGMEM= "rx";
+  const char* topicRxPack PROGMEM= "rx_mp";
+  char rxTopic[128] = "";
+  bool rxMsgPack = false;      // latched at welcome, where the format is announced
+  static const size_t RX_BATCH_SIZE = MQTT_MAX_PACKET_SIZE - sizeof(rxTopic) - 7; // MQTT header and topic length
+  RxBatch<RX_BATCH_SIZE> rxBatch;
+  unsigned long rxBatchStart = 0;
   const char* topicGet_adv_prm PROGMEM = "get_adv_prm";
 
   // command
   const char* commandBatchConf PROGMEM= "batch_conf";
   const char* commandUpdate PROGMEM= "update";
   const char* commandSatPos PROGMEM= "sat_pos_oled";
+  const char* commandTle PROGMEM= "tle";
   const char* commandReset PROGMEM= "reset";
   const char* commandFreq PROGMEM= "freq";
   const char* commandBw PROGMEM= "bw";
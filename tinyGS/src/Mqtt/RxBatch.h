@@ -0,0 +1,158 @@
+/*
+  RxBatch.h - Received frames packed as MessagePack for the binary uplink
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef RX_BATCH_H
+#define RX_BATCH_H
+
+#include <stdint.h>
+#include <string.h>
+#include "ArduinoJson.h"
+#include "../Status.h"
+
+// A batch is a MessagePack array. Its first element is a map with the modem
+// settings shared by every frame, each following element is one frame:
+//   [rx_usec_time, rssi, snr, frequency_error, crc_error, rs_corrected, noisy, data]
+// data is a bin (empty on CRC errors), so payloads travel without base64.
+// Station metadata is not repeated here, it goes once in the welcome message.
+template <size_t SIZE>
+class RxBatch {
+public:
+  static const uint8_t MAX_FRAMES = 14; // header + frames must fit a fixarray
+
+  bool empty() const { return frames == 0; }
+  bool full() const { return frames == MAX_FRAMES; }
+  uint8_t count() const { return frames; }
+  const uint8_t* data() const { return buffer; }
+  size_t size() const { return length; }
+
+  // starts a new batch, the header document is serialized once for all its frames
+  bool open(const JsonDocument& header)
+  {
+    frames = 0;
+    length = 1 + serializeMsgPack(header, (char*)buffer + 1, SIZE - 1);
+    first = length;
+    buffer[0] = 0x91;
+    return length < SIZE;
+  }
+
+  // false when the frame does not fit, the batch is left as it was
+  bool add(const RxFrame& frame)
+  {
+    size_t dataLen = frame.crc_error ? 0 : frame.length;
+    if (full() || length + FRAME_OVERHEAD + dataLen > SIZE)
+      return false;
+
+    put(0x98); // fixarray of 8
+    put(0xd3); putBE((uint64_t)frame.irqUnixUsec, 8);
+    putFloat(frame.rssi);
+    putFloat(frame.snr);
+    putFloat(frame.frequencyerror);
+    put(frame.crc_error ? 0xc3 : 0xc2);
+    put(0xd1); putBE((uint16_t)frame.rs_corrected, 2);
+    put(frame.noisy ? 0xc3 : 0xc2);
+    if (dataLen > 0xFF)
+    {
+      put(0xc5); putBE(dataLen, 2);
+    }
+    else
+    {
+      put(0xc4); put(dataLen);
+    }
+    memcpy(buffer + length, frame.data, dataLen);
+    length += dataLen;
+
+    frames++;
+    buffer[0] = 0x90 | (1 + frames);
+    return true;
+  }
+
+  // reads frame index back, for the frames of a batch that was not published
+  bool get(uint8_t index, RxFrame& frame) const
+  {
+    if (index >= frames)
+      return false;
+
+    size_t pos = first;
+    for (uint8_t i = 0; ; i++)
+    {
+      size_t bin = pos + FRAME_OVERHEAD - 3; // the fields ahead of data have a fixed size
+      size_t dataPos = bin + (buffer[bin] == 0xc5 ? 3 : 2);
+      size_t dataLen = buffer[bin] == 0xc5 ? getBE(bin + 1, 2) : buffer[bin + 1];
+      if (i == index)
+      {
+        memset(&frame, 0, sizeof(frame));
+        frame.irqUnixUsec = (int64_t)getBE(pos + 2, 8);
+        frame.rssi = getFloat(pos + 10);
+        frame.snr = getFloat(pos + 15);
+        frame.frequencyerror = getFloat(pos + 20);
+        frame.crc_error = buffer[pos + 25] == 0xc3;
+        frame.rs_corrected = (int16_t)getBE(pos + 27, 2);
+        frame.noisy = buffer[pos + 29] == 0xc3;
+        frame.length = dataLen;
+        memcpy(frame.data, buffer + dataPos, dataLen);
+        return true;
+      }
+      pos = dataPos + dataLen;
+    }
+  }
+
+  void clear()
+  {
+    frames = 0;
+    length = 0;
+  }
+
+private:
+  static const size_t FRAME_OVERHEAD = 1 + 9 + 3 * 5 + 1 + 3 + 1 + 3;
+
+  void put(uint8_t b) { buffer[length++] = b; }
+  void putBE(uint64_t v, uint8_t bytes)
+  {
+    while (bytes--)
+      put(v >> (8 * bytes));
+  }
+  void putFloat(float f)
+  {
+    uint32_t bits;
+    memcpy(&bits, &f, sizeof(bits));
+    put(0xca);
+    putBE(bits, 4);
+  }
+  uint64_t getBE(size_t pos, uint8_t bytes) const
+  {
+    uint64_t v = 0;
+    while (bytes--)
+      v = (v << 8) | buffer[pos++];
+    return v;
+  }
+  float getFloat(size_t pos) const
+  {
+    uint32_t bits = getBE(pos + 1, 4); // past the float32 marker
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    return f;
+  }
+
+  uint8_t buffer[SIZE];
+  size_t length = 0;
+  size_t first = 0;    // where the frames start, past the header
+  uint8_t frames = 0;
+};
+
+#endif
@@ -0,0 +1,223 @@
+/*
+  Orbit.cpp - Passes of the tracked satellite over the station
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Orbit.h"
+#include "../ConfigManager/ConfigManager.h"
+#include "../Radio/Radio.h"
+#include "../Logger/Logger.h"
+
+static const double DEG2RAD = M_PI / 180.0;
+static const double EARTH_RADIUS = 6378.137;      // km, WGS-84
+static const double EARTH_FLATTENING = 1 / 298.257223563;
+static const double EARTH_ROTATION = 7.292115e-5; // rad/s
+
+// The last TLE received survives a reboot, a pass can be followed before the server is reachable
+void Orbit::begin()
+{
+  prefs.begin("tinygs", true);
+  bool found = prefs.getBytes("tle", tle, sizeof(tle)) == sizeof(tle);
+  prefs.end();
+  tle[0][TLE_LINE - 1] = tle[1][TLE_LINE - 1] = '\0';
+  if (found && sgp4.init(tle[0], tle[1]))
+  {
+    loaded = true;
+    Log::console(PSTR("Orbit of NORAD %u loaded"), sgp4.getNorad());
+  }
+}
+
+bool Orbit::setTle(const char* line1, const char* line2)
+{
+  Sgp4 elements;
+  if (!elements.init(line1, line2))
+  {
+    Log::console(PSTR("Invalid or deep space TLE, orbit not updated"));
+    return false;
+  }
+
+  sgp4 = elements;
+  loaded = true;
+  strlcpy(tle[0], line1, TLE_LINE);
+  strlcpy(tle[1], line2, TLE_LINE);
+  prefs.begin("tinygs", false);
+  prefs.putBytes("tle", tle, sizeof(tle));
+  prefs.end();
+
+  pass = Pass();
+  searchTime = 0;
+  lastLook = millis() - LOOK_INTERVAL;
+  Log::console(PSTR("Orbit of NORAD %u updated, epoch %u"), sgp4.getNorad(), (uint32_t)sgp4.getEpoch());
+  return true;
+}
+
+// The TLE only means something while it belongs to the satellite being listened to
+bool Orbit::valid()
+{
+  return loaded && sgp4.getNorad() == status.modeminfo.NORAD && time(NULL) > 1600000000;
+}
+
+bool Orbit::txAllowed()
+{
+  if (!valid())
+    return true; // without an orbit the operator decides
+  return currentValid && current.elevation >= ConfigManager::getInstance().getMinElevation();
+}
+
+bool Orbit::look(double unixTime, LookAngles& angles)
+{
+  double r[3], v[3];
+  if (!sgp4.propagate(unixTime, r, v))
+    return false;
+
+  // TEME to earth fixed, polar motion is well below what matters here
+  double theta = Sgp4::gmst(unixTime);
+  double c = cos(theta), s = sin(theta);
+  double x = c * r[0] + s * r[1];
+  double y = -s * r[0] + c * r[1];
+  double z = r[2];
+  double vx = c * v[0] + s * v[1] + EARTH_ROTATION * y;
+  double vy = -s * v[0] + c * v[1] - EARTH_ROTATION * x;
+  double vz = v[2];
+
+  // the station on the ellipsoid, at sea level
+  ConfigManager& configManager = ConfigManager::getInstance();
+  double lat = configManager.getLatitude() * DEG2RAD;
+  double lon = configManager.getLongitude() * DEG2RAD;
+  double sinLat = sin(lat), cosLat = cos(lat), sinLon = sin(lon), cosLon = cos(lon);
+  double e2 = EARTH_FLATTENING * (2 - EARTH_FLATTENING);
+  double n = EARTH_RADIUS / sqrt(1 - e2 * sinLat * sinLat);
+  double dx = x - n * cosLat * cosLon;
+  double dy = y - n * cosLat * sinLon;
+  double dz = z - n * (1 - e2) * sinLat;
+
+  // south, east, zenith
+  double south = sinLat * cosLon * dx + sinLat * sinLon * dy - cosLat * dz;
+  double east = -sinLon * dx + cosLon * dy;
+  double zenith = cosLat * cosLon * dx + cosLat * sinLon * dy + sinLat * dz;
+  double range = sqrt(dx * dx + dy * dy + dz * dz);
+
+  angles.elevation = asin(zenith / range) / DEG2RAD;
+  angles.azimuth = fmod(atan2(east, -south) / DEG2RAD + 360, 360);
+  angles.range = range;
+  angles.rangeRate = (dx * vx + dy * vy + dz * vz) / range;
+  angles.latitude = atan2(z, sqrt(x * x + y * y)) / DEG2RAD;
+  angles.longitude = atan2(y, x) / DEG2RAD;
+  return true;
+}
+
+void Orbit::loop()
+{
+  if (!valid() || millis() - lastLook < LOOK_INTERVAL)
+    return;
+  lastLook = millis();
+
+  uint32_t now = time(NULL);
+  currentValid = look(now, current);
+  if (!currentValid)
+    return;
+
+  // the world map of the display and the web panel is 128x64 pixels
+  status.satPos[0] = (current.longitude + 180) * 128 / 360;
+  status.satPos[1] = (90 - current.latitude) * 64 / 180;
+
+  searchPass(now);
+  manageRadio(now);
+}
+
+// Walks forward SEARCH_STEP at a time until the satellite rises and sets again
+void Orbit::searchPass(uint32_t now)
+{
+  if (pass.los && now <= pass.los)
+    return; // the pass ahead is known
+  if (pass.los)
+  {
+    Log::console(PSTR("Pass over, LOS at %u"), pass.los);
+    pass = Pass();
+    searchTime = 0;
+  }
+  if (!searchTime || searchTime > now + SEARCH_SPAN)
+  {
+    // nothing within a day, or a new search
+    searchTime = now;
+    searchAbove = currentValid && current.elevation >= 0;
+    candidate = Pass();
+    if (searchAbove)
+      candidate.aos = now; // already in view
+  }
+
+  for (uint8_t step = 0; step < SEARCH_STEPS_PER_LOOP; step++)
+  {
+    LookAngles angles;
+    uint32_t t = searchTime + SEARCH_STEP;
+    if (!look(t, angles))
+      return;
+
+    if (!searchAbove && angles.elevation >= 0)
+    {
+      candidate.aos = refine(searchTime, t);
+      searchAbove = true;
+    }
+    else if (searchAbove && angles.elevation < 0)
+    {
+      candidate.los = refine(t, searchTime);
+      pass = candidate;
+      Log::console(PSTR("Next pass of NORAD %u: AOS %u LOS %u, max elevation %.1f deg"), sgp4.getNorad(), pass.aos, pass.los, pass.maxElevation);
+      return;
+    }
+    if (searchAbove && angles.elevation > candidate.maxElevation)
+      candidate.maxElevation = angles.elevation;
+    searchTime = t;
+  }
+}
+
+// Bisects to the second when the satellite crosses the horizon, below is under it
+uint32_t Orbit::refine(uint32_t below, uint32_t above)
+{
+  while (below + 1 < above || above + 1 < below)
+  {
+    uint32_t middle = below / 2 + above / 2 + (below & above & 1);
+    LookAngles angles;
+    if (!look(middle, angles))
+      break;
+    if (angles.elevation >= 0)
+      above = middle;
+    else
+      below = middle;
+  }
+  return above;
+}
+
+// With low power set the radio sleeps from LOS to shortly before the next AOS
+void Orbit::manageRadio(uint32_t now)
+{
+  Radio& radio = Radio::getInstance();
+  if (!ConfigManager::getInstance().getLowPower() || !radio.isReady())
+    return;
+
+  bool needed = !pass.aos || now + PRETUNE_LEAD >= pass.aos;
+  if (!needed && !radio.isSleeping())
+  {
+    if (radio.sleep())
+      Log::console(PSTR("Radio sleeping until %u, %u s before AOS"), pass.aos - PRETUNE_LEAD, PRETUNE_LEAD);
+  }
+  else if (needed && radio.isSleeping())
+  {
+    Log::console(PSTR("Waking the radio for the pass at %u"), pass.aos);
+    radio.begin();
+  }
+}
@@ -0,0 +1,90 @@
+/*
+  Orbit.h - Passes of the tracked satellite over the station
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef ORBIT_H
+#define ORBIT_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "Sgp4.h"
+
+struct Pass {
+  uint32_t aos = 0;          // unix time, 0 while no pass was found
+  uint32_t los = 0;
+  float maxElevation = 0;    // deg
+};
+
+// Where the satellite is seen from the station
+struct LookAngles {
+  float elevation;           // deg
+  float azimuth;             // deg
+  float range;               // km
+  float rangeRate;           // km/s, positive while moving away
+  float latitude;            // deg, sub satellite point
+  float longitude;
+};
+
+// Propagates the TLE the server sends for the tracked satellite, so pass
+// times, pointing and the TX window no longer wait for the server. Passes are
+// searched a few steps per loop, the loop is never held for a whole day of
+// propagation.
+class Orbit {
+public:
+  static Orbit& getInstance()
+  {
+    static Orbit instance;
+    return instance;
+  }
+
+  void begin();
+  void loop();
+  bool setTle(const char* line1, const char* line2);
+  bool valid();
+  bool txAllowed();
+  const LookAngles& getLook() { return current; }
+  const Pass& getPass() { return pass; }
+  bool look(double unixTime, LookAngles& angles);
+
+private:
+  Orbit() {};
+  void searchPass(uint32_t now);
+  uint32_t refine(uint32_t below, uint32_t above);
+  void manageRadio(uint32_t now);
+
+  static const uint32_t LOOK_INTERVAL = 1000;  // ms between updates of the look angles
+  static const uint32_t SEARCH_STEP = 60;      // s, coarse step of the pass search
+  static const uint32_t SEARCH_SPAN = 86400;   // s ahead of now
+  static const uint8_t SEARCH_STEPS_PER_LOOP = 30;
+  static const uint32_t PRETUNE_LEAD = 60;     // s before AOS the radio is listening again
+  static const size_t TLE_LINE = 70;
+
+  Sgp4 sgp4;
+  bool loaded = false;
+  char tle[2][TLE_LINE] = {"", ""};
+  Preferences prefs;
+  LookAngles current = {-90, 0, 0, 0, 0, 0};
+  bool currentValid = false;
+  unsigned long lastLook = 0;
+  Pass pass;
+  Pass candidate;            // pass being searched
+  uint32_t searchTime = 0;   // next instant the search looks at, 0 restarts it
+  bool searchAbove = false;  // the search is inside a pass
+};
+
+#endif
@@ -0,0 +1,300 @@
+/*
+  Sgp4.cpp - SGP4 orbit propagator for two line elements
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Sgp4.h"
+
+static const double RADIUS_EARTH = 6378.135; // km, WGS-72
+static const double XKE = 0.0743669161331734;  // sqrt(GM) in earth radii^1.5 / min
+static const double J2 = 0.001082616;
+static const double J3 = -0.00000253881;
+static const double J4 = -0.00000165597;
+static const double J3OJ2 = J3 / J2;
+static const double X2O3 = 2.0 / 3.0;
+static const double TWO_PI = 2.0 * M_PI;
+static const double DEG2RAD = M_PI / 180.0;
+
+// Columns are 1 based and inclusive, as in the TLE format description
+bool Sgp4::field(const char* line, int from, int to, double& value)
+{
+  char buffer[16];
+  int n = 0;
+  for (int i = from - 1; i < to; i++)
+    if (line[i] != ' ')
+      buffer[n++] = line[i];
+  buffer[n] = '\0';
+  if (!n)
+    return false;
+  char* end;
+  value = strtod(buffer, &end);
+  return *end == '\0';
+}
+
+bool Sgp4::init(const char* line1, const char* line2)
+{
+  // the checksum column is not needed
+  if (strlen(line1) < 68 || strlen(line2) < 68 || line1[0] != '1' || line2[0] != '2')
+    return false;
+
+  double catalog, year, day, ndot, inclination, raan, argp, meanAnomaly, meanMotion;
+  char eccentricity[10] = "0.";
+  strncpy(eccentricity + 2, line2 + 26, 7);
+  eccentricity[9] = '\0';
+  ecco = atof(eccentricity);
+  if (!field(line1, 3, 7, catalog) || !field(line1, 19, 20, year) || !field(line1, 21, 32, day) ||
+      !field(line1, 34, 43, ndot) || !field(line2, 9, 16, inclination) || !field(line2, 18, 25, raan) ||
+      !field(line2, 35, 42, argp) || !field(line2, 44, 51, meanAnomaly) || !field(line2, 53, 63, meanMotion))
+    return false;
+
+  // B* is written as an implied decimal mantissa and a power of ten, " 12345-3" is 0.12345e-3
+  double mantissa, exponent;
+  char sign = line1[53];
+  if (!field(line1, 55, 59, mantissa) || !field(line1, 60, 61, exponent))
+    return false;
+  bstar = (sign == '-' ? -1 : 1) * mantissa * 1e-5 * pow(10.0, exponent);
+
+  norad = catalog;
+  int fullYear = year < 57 ? 2000 + year : 1900 + year;
+  long days = 0;
+  for (int y = 1970; y < fullYear; y++)
+    days += (y % 4 == 0 && (y % 100 != 0 || y % 400 == 0)) ? 366 : 365;
+  epoch = (days + day - 1) * 86400.0;
+
+  inclo = inclination * DEG2RAD;
+  nodeo = raan * DEG2RAD;
+  argpo = argp * DEG2RAD;
+  mo = meanAnomaly * DEG2RAD;
+  double noKozai = meanMotion * TWO_PI / 1440.0; // rad/min
+  if (noKozai <= 0 || ecco >= 1)
+    return false;
+
+  // recover the original mean motion and semimajor axis from the elements
+  double eccsq = ecco * ecco;
+  double omeosq = 1.0 - eccsq;
+  double rteosq = sqrt(omeosq);
+  double cosio = cos(inclo);
+  double cosio2 = cosio * cosio;
+  double ak = pow(XKE / noKozai, X2O3);
+  double d1 = 0.75 * J2 * (3.0 * cosio2 - 1.0) / (rteosq * omeosq);
+  double del = d1 / (ak * ak);
+  double adel = ak * (1.0 - del * del - del * (1.0 / 3.0 + 134.0 * del * del / 81.0));
+  del = d1 / (adel * adel);
+  no = noKozai / (1.0 + del);
+  if (TWO_PI / no >= 225.0)
+    return false; // deep space
+
+  double ao = pow(XKE / no, X2O3);
+  double sinio = sin(inclo);
+  double po = ao * omeosq;
+  double con42 = 1.0 - 5.0 * cosio2;
+  con41 = -con42 - cosio2 - cosio2;
+  double posq = po * po;
+  double rp = ao * (1.0 - ecco);
+
+  // perigees below 220 km drop the higher order drag terms
+  isimp = rp < 220.0 / RADIUS_EARTH + 1.0;
+  double sfour = 78.0 / RADIUS_EARTH + 1.0;
+  double qzms24 = pow((120.0 - 78.0) / RADIUS_EARTH, 4);
+  double perige = (rp - 1.0) * RADIUS_EARTH;
+  if (perige < 156.0)
+  {
+    sfour = perige < 98.0 ? 20.0 : perige - 78.0;
+    qzms24 = pow((120.0 - sfour) / RADIUS_EARTH, 4);
+    sfour = sfour / RADIUS_EARTH + 1.0;
+  }
+  double pinvsq = 1.0 / posq;
+  double tsi = 1.0 / (ao - sfour);
+  eta = ao * ecco * tsi;
+  double etasq = eta * eta;
+  double eeta = ecco * eta;
+  double psisq = fabs(1.0 - etasq);
+  double coef = qzms24 * pow(tsi, 4);
+  double coef1 = coef / pow(psisq, 3.5);
+  double cc2 = coef1 * no * (ao * (1.0 + 1.5 * etasq + eeta * (4.0 + etasq)) +
+               0.375 * J2 * tsi / psisq * con41 * (8.0 + 3.0 * etasq * (8.0 + etasq)));
+  cc1 = bstar * cc2;
+  double cc3 = ecco > 1.0e-4 ? -2.0 * coef * tsi * J3OJ2 * no * sinio / ecco : 0;
+  x1mth2 = 1.0 - cosio2;
+  cc4 = 2.0 * no * coef1 * ao * omeosq * (eta * (2.0 + 0.5 * etasq) + ecco * (0.5 + 2.0 * etasq) -
+        J2 * tsi / (ao * psisq) * (-3.0 * con41 * (1.0 - 2.0 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+        0.75 * x1mth2 * (2.0 * etasq - eeta * (1.0 + etasq)) * cos(2.0 * argpo)));
+  cc5 = 2.0 * coef1 * ao * omeosq * (1.0 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+  double cosio4 = cosio2 * cosio2;
+  double temp1 = 1.5 * J2 * pinvsq * no;
+  double temp2 = 0.5 * temp1 * J2 * pinvsq;
+  double temp3 = -0.46875 * J4 * pinvsq * pinvsq * no;
+  mdot = no + 0.5 * temp1 * rteosq * con41 + 0.0625 * temp2 * rteosq * (13.0 - 78.0 * cosio2 + 137.0 * cosio4);
+  argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7.0 - 114.0 * cosio2 + 395.0 * cosio4) +
+            temp3 * (3.0 - 36.0 * cosio2 + 49.0 * cosio4);
+  double xhdot1 = -temp1 * cosio;
+  nodedot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * cosio2) + 2.0 * temp3 * (3.0 - 7.0 * cosio2)) * cosio;
+  omgcof = bstar * cc3 * cos(argpo);
+  xmcof = ecco > 1.0e-4 ? -X2O3 * coef * bstar / eeta : 0;
+  nodecf = 3.5 * omeosq * xhdot1 * cc1;
+  t2cof = 1.5 * cc1;
+  xlcof = -0.25 * J3OJ2 * sinio * (3.0 + 5.0 * cosio) / (fabs(cosio + 1.0) > 1.5e-12 ? 1.0 + cosio : 1.5e-12);
+  aycof = -0.5 * J3OJ2 * sinio;
+  delmo = pow(1.0 + eta * cos(mo), 3);
+  sinmao = sin(mo);
+  x7thm1 = 7.0 * cosio2 - 1.0;
+
+  if (!isimp)
+  {
+    double cc1sq = cc1 * cc1;
+    d2 = 4.0 * ao * tsi * cc1sq;
+    double temp = d2 * tsi * cc1 / 3.0;
+    d3 = (17.0 * ao + sfour) * temp;
+    d4 = 0.5 * temp * ao * tsi * (221.0 * ao + 31.0 * sfour) * cc1;
+    t3cof = d2 + 2.0 * cc1sq;
+    t4cof = 0.25 * (3.0 * d3 + cc1 * (12.0 * d2 + 10.0 * cc1sq));
+    t5cof = 0.2 * (3.0 * d4 + 12.0 * cc1 * d3 + 6.0 * d2 * d2 + 15.0 * cc1sq * (2.0 * d2 + cc1sq));
+  }
+  return true;
+}
+
+// False once the elements no longer describe an orbit, the satellite has decayed
+bool Sgp4::propagate(double unixTime, double r[3], double v[3]) const
+{
+  double t = (unixTime - epoch) / 60.0;
+
+  // secular gravity and atmospheric drag
+  double xmdf = mo + mdot * t;
+  double argpdf = argpo + argpdot * t;
+  double nodedf = nodeo + nodedot * t;
+  double argpm = argpdf;
+  double mm = xmdf;
+  double t2 = t * t;
+  double nodem = nodedf + nodecf * t2;
+  double tempa = 1.0 - cc1 * t;
+  double tempe = bstar * cc4 * t;
+  double templ = t2cof * t2;
+  if (!isimp)
+  {
+    double delomg = omgcof * t;
+    double delm = xmcof * (pow(1.0 + eta * cos(xmdf), 3) - delmo);
+    double temp = delomg + delm;
+    mm = xmdf + temp;
+    argpm = argpdf - temp;
+    double t3 = t2 * t;
+    double t4 = t3 * t;
+    tempa = tempa - d2 * t2 - d3 * t3 - d4 * t4;
+    tempe = tempe + bstar * cc5 * (sin(mm) - sinmao);
+    templ = templ + t3cof * t3 + t4 * (t4cof + t * t5cof);
+  }
+
+  double am = pow(XKE / no, X2O3) * tempa * tempa;
+  double nm = XKE / pow(am, 1.5);
+  double em = ecco - tempe;
+  if (em >= 1.0 || em < -0.001 || am < 0.95)
+    return false;
+  if (em < 1.0e-6)
+    em = 1.0e-6;
+  mm = mm + no * templ;
+  double xlm = mm + argpm + nodem;
+  nodem = fmod(nodem, TWO_PI);
+  argpm = fmod(argpm, TWO_PI);
+  xlm = fmod(xlm, TWO_PI);
+  mm = fmod(xlm - argpm - nodem, TWO_PI);
+
+  // long period periodics
+  double axnl = em * cos(argpm);
+  double temp = 1.0 / (am * (1.0 - em * em));
+  double aynl = em * sin(argpm) + temp * aycof;
+  double xl = mm + argpm + nodem + temp * xlcof * axnl;
+
+  // Kepler's equation
+  double u = fmod(xl - nodem, TWO_PI);
+  double eo1 = u;
+  double tem5 = 9999.9;
+  double sineo1 = 0, coseo1 = 0;
+  for (int ktr = 0; fabs(tem5) >= 1.0e-12 && ktr < 10; ktr++)
+  {
+    sineo1 = sin(eo1);
+    coseo1 = cos(eo1);
+    tem5 = 1.0 - coseo1 * axnl - sineo1 * aynl;
+    tem5 = (u - aynl * coseo1 + axnl * sineo1 - eo1) / tem5;
+    if (fabs(tem5) >= 0.95)
+      tem5 = tem5 > 0.0 ? 0.95 : -0.95;
+    eo1 += tem5;
+  }
+
+  // short period periodics
+  double ecose = axnl * coseo1 + aynl * sineo1;
+  double esine = axnl * sineo1 - aynl * coseo1;
+  double el2 = axnl * axnl + aynl * aynl;
+  double pl = am * (1.0 - el2);
+  if (pl < 0.0)
+    return false;
+  double rl = am * (1.0 - ecose);
+  double rdotl = sqrt(am) * esine / rl;
+  double rvdotl = sqrt(pl) / rl;
+  double betal = sqrt(1.0 - el2);
+  temp = esine / (1.0 + betal);
+  double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+  double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+  double su = atan2(sinu, cosu);
+  double sin2u = (cosu + cosu) * sinu;
+  double cos2u = 1.0 - 2.0 * sinu * sinu;
+  temp = 1.0 / pl;
+  double temp1 = 0.5 * J2 * temp;
+  double temp2 = temp1 * temp;
+
+  double cosip = cos(inclo);
+  double sinip = sin(inclo);
+  double mrt = rl * (1.0 - 1.5 * temp2 * betal * con41) + 0.5 * temp1 * x1mth2 * cos2u;
+  su = su - 0.25 * temp2 * x7thm1 * sin2u;
+  double xnode = nodem + 1.5 * temp2 * cosip * sin2u;
+  double xinc = inclo + 1.5 * temp2 * cosip * sinip * cos2u;
+  double mvt = rdotl - nm * temp1 * x1mth2 * sin2u / XKE;
+  double rvdot = rvdotl + nm * temp1 * (x1mth2 * cos2u + 1.5 * con41) / XKE;
+  if (mrt < 1.0)
+    return false;
+
+  // orientation vectors
+  double sinsu = sin(su), cossu = cos(su);
+  double snod = sin(xnode), cnod = cos(xnode);
+  double sini = sin(xinc), cosi = cos(xinc);
+  double xmx = -snod * cosi;
+  double xmy = cnod * cosi;
+  double ux = xmx * sinsu + cnod * cossu;
+  double uy = xmy * sinsu + snod * cossu;
+  double uz = sini * sinsu;
+  double vx = xmx * cossu - cnod * sinsu;
+  double vy = xmy * cossu - snod * sinsu;
+  double vz = sini * cossu;
+
+  const double vkmpersec = RADIUS_EARTH * XKE / 60.0;
+  r[0] = mrt * ux * RADIUS_EARTH;
+  r[1] = mrt * uy * RADIUS_EARTH;
+  r[2] = mrt * uz * RADIUS_EARTH;
+  v[0] = (mvt * ux + rvdot * vx) * vkmpersec;
+  v[1] = (mvt * uy + rvdot * vy) * vkmpersec;
+  v[2] = (mvt * uz + rvdot * vz) * vkmpersec;
+  return true;
+}
+
+// Greenwich mean sidereal time in radians, IAU-82
+double Sgp4::gmst(double unixTime)
+{
+  double tut1 = (unixTime / 86400.0 - 10957.5) / 36525.0; // centuries since J2000
+  double temp = -6.2e-6 * tut1 * tut1 * tut1 + 0.093104 * tut1 * tut1 +
+                (876600.0 * 3600.0 + 8640184.812866) * tut1 + 67310.54841; // s
+  temp = fmod(temp * DEG2RAD / 240.0, TWO_PI);
+  return temp < 0 ? temp + TWO_PI : temp;
+}
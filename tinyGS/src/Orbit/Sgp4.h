@@ -0,0 +1,50 @@
+/*
+  Sgp4.h - SGP4 orbit propagator for two line elements
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef SGP4_H
+#define SGP4_H
+
+#include <Arduino.h>
+
+// Near earth SGP4 as in Spacetrack Report #3 with the corrections of
+// Vallado et al. (AIAA 2006-6753), WGS-72 constants. Satellites with a
+// period of 225 minutes or more need the SDP4 deep space terms and are
+// rejected, every satellite the network follows is far below that.
+// Positions and velocities are TEME, in km and km/s.
+class Sgp4 {
+public:
+  bool init(const char* line1, const char* line2);
+  bool propagate(double unixTime, double r[3], double v[3]) const;
+  uint32_t getNorad() const { return norad; }
+  double getEpoch() const { return epoch; }
+  static double gmst(double unixTime);
+
+private:
+  static bool field(const char* line, int from, int to, double& value);
+
+  uint32_t norad = 0;
+  double epoch = 0; // unix time
+  bool isimp = false;
+  double bstar, ecco, inclo, nodeo, argpo, mo, no;
+  double aycof, con41, cc1, cc4, cc5, d2, d3, d4, delmo, eta, argpdot, omgcof,
+         sinmao, t2cof, t3cof, t4cof, t5cof, x1mth2, x7thm1, mdot, nodedot,
+         xlcof, xmcof, nodecf;
+};
+
+#endif
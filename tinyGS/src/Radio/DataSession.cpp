@@ -0,0 +1,235 @@
+/*
+  DataSession.cpp - Selective repeat download of the SEND DATA frames
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "DataSession.h"
+#include "Radio.h"
+#include "Telecommands.h"
+#include "../Orbit/Orbit.h"
+#include "../Logger/Logger.h"
+
+DataSession::DataSession()
+{
+  mutex = xSemaphoreCreateMutex();
+}
+
+// Called instead of sending SEND DATA when a stored transfer of this satellite
+// can be resumed, true when there was one and its missing frames were requested.
+// The session only runs once that ACK DATA was accepted by the radio
+bool DataSession::resume()
+{
+  uint8_t size = constrain(ConfigManager::getInstance().getArqWindow(), 1, SEQ_SPACE);
+  Stored stored;
+  prefs.begin("tinygs", false);
+  bool found = prefs.getBytes("arq", &stored, sizeof(stored)) == sizeof(stored);
+  prefs.end();
+  if (!found || stored.magic != MAGIC || stored.norad != status.modeminfo.NORAD || stored.window != size ||
+      (uint32_t)time(NULL) - stored.started >= RESUME_AGE)
+    return false;
+
+  Ack ack;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  window = size;
+  received = stored.received & windowMask();
+  started = stored.started;
+  rounds = stored.rounds;
+  idleRounds = 0;
+  progress = false;
+  roundLast = lastMissing();
+  lastFrame = millis();
+  buildAck(ack);
+  xSemaphoreGive(mutex);
+
+  Log::console(PSTR("Resuming data download, %u of %u frames already received"), ack.received, ack.window);
+  if (sendAck(ack))
+  {
+    xSemaphoreTake(mutex, portMAX_DELAY);
+    running = true;
+    xSemaphoreGive(mutex);
+  }
+  return true;
+}
+
+// A new transfer, once SEND DATA was accepted by the radio
+void DataSession::start()
+{
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  window = constrain(ConfigManager::getInstance().getArqWindow(), 1, SEQ_SPACE);
+  received = 0;
+  started = time(NULL);
+  rounds = 0;
+  idleRounds = 0;
+  progress = false;
+  roundLast = window - 1;
+  lastFrame = millis();
+  running = true;
+  xSemaphoreGive(mutex);
+}
+
+// Every frame received while the transfer is running, from the decoder task
+void DataSession::onFrame(const uint8_t* frame, size_t length)
+{
+  if (length < 4)
+  {
+    Log::console(PSTR("Data frame too short (%u bytes), ignored"), length);
+    return;
+  }
+
+  Ack ack;
+  bool closed = false;
+  uint8_t seq = frame[3];
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  uint8_t size = window;
+  if (running && seq < window)
+  {
+    if (!(received & (1u << seq)))
+    {
+      received |= 1u << seq;
+      progress = true;
+    }
+    lastFrame = millis();
+    closed = complete() || seq == roundLast;
+    if (closed)
+      closeRound(ack);
+  }
+  bool ignored = running && seq >= window;
+  xSemaphoreGive(mutex);
+
+  if (ignored)
+    Log::console(PSTR("Data frame %u outside the window of %u, ignored"), seq, size);
+  if (closed)
+    sendAck(ack);
+}
+
+// Ends the round when the satellite went quiet and writes the transfer to NVS,
+// from the main loop so the decoder task never waits on the flash
+void DataSession::loop()
+{
+  if (!running && pending == PERSIST_NONE)
+    return;
+
+  Ack ack;
+  bool closed = false;
+  xSemaphoreTake(mutex, portMAX_DELAY);
+  if (running && millis() - lastFrame > ConfigManager::getInstance().getArqTimeoutMs())
+  {
+    Log::console(PSTR("No data frame for %u ms"), ConfigManager::getInstance().getArqTimeoutMs());
+    closeRound(ack);
+    closed = true;
+  }
+  Persist persist = pending;
+  Stored stored = {MAGIC, status.modeminfo.NORAD, started, received, window, rounds};
+  pending = PERSIST_NONE;
+  xSemaphoreGive(mutex);
+
+  if (closed)
+    sendAck(ack);
+  if (persist == PERSIST_SAVE)
+    save(stored);
+  else if (persist == PERSIST_CLEAR)
+    clear();
+}
+
+// Mutex held. Builds the ACK DATA of the round and schedules the NVS write,
+// both are left to the caller once the mutex is released
+void DataSession::closeRound(Ack& ack)
+{
+  rounds++;
+  buildAck(ack);
+  if (complete())
+  {
+    Log::console(PSTR("Data download complete, %u frames in %u rounds"), window, rounds);
+    running = false;
+    pending = PERSIST_CLEAR;
+    return;
+  }
+
+  idleRounds = progress ? 0 : idleRounds + 1;
+  progress = false;
+  pending = PERSIST_SAVE;
+  if (idleRounds >= MAX_IDLE_ROUNDS)
+  {
+    Log::console(PSTR("Data download stopped with %u of %u frames, the next SEND DATA resumes it"), __builtin_popcount(received), window);
+    running = false;
+    return;
+  }
+  roundLast = lastMissing();
+  lastFrame = millis();
+}
+
+uint8_t DataSession::lastMissing()
+{
+  uint8_t last = 0;
+  for (uint8_t seq = 0; seq < window; seq++)
+    if (!(received & (1u << seq)))
+      last = seq;
+  return last;
+}
+
+// Mutex held. Slots past the window are marked received, there is nothing to send for them
+void DataSession::buildAck(Ack& ack)
+{
+  size_t length = sizeof(Telecommands::HEADER);
+  memcpy(ack.tc, Telecommands::HEADER, length);
+  ack.tc[length++] = ACK_OPCODE;
+  for (uint8_t seq = 0; seq < SEQ_SPACE; seq++)
+    ack.tc[length++] = seq >= window || (received & (1u << seq)) ? 0x01 : 0x00;
+  uint32_t unixTime32 = (uint32_t)time(NULL);
+  ack.tc[length++] = (unixTime32 >> 24) & 0xFF;
+  ack.tc[length++] = (unixTime32 >> 16) & 0xFF;
+  ack.tc[length++] = (unixTime32 >> 8) & 0xFF;
+  ack.tc[length++] = unixTime32 & 0xFF;
+  ack.received = __builtin_popcount(received);
+  ack.window = window;
+}
+
+// Mutex not held, the radio takes its own lock. False when the radio refused it
+bool DataSession::sendAck(const Ack& ack)
+{
+  if (!Orbit::getInstance().txAllowed())
+  {
+    Log::console(PSTR("ACK DATA not sent, satellite at %.1f deg is below the minimum elevation"), Orbit::getInstance().getLook().elevation);
+    return false;
+  }
+
+  uint8_t encoded[256];
+  size_t size = Telecommands::getInstance().encode(ack.tc, sizeof(ack.tc), encoded);
+  int16_t state = size ? Radio::getInstance().sendTx(encoded, size, 2, 500000) : ERR_PACKET_TOO_LONG;
+  if (state != ERR_NONE)
+  {
+    Log::console(PSTR("ACK DATA not sent (%d)"), state);
+    return false;
+  }
+  Log::console(PSTR("Sending ACK DATA, %u of %u frames received"), ack.received, ack.window);
+  return true;
+}
+
+// Once per round, NVS wears far less than one write per frame
+void DataSession::save(const Stored& stored)
+{
+  prefs.begin("tinygs", false);
+  prefs.putBytes("arq", &stored, sizeof(stored));
+  prefs.end();
+}
+
+void DataSession::clear()
+{
+  prefs.begin("tinygs", false);
+  prefs.remove("arq");
+  prefs.end();
+}
@@ -0,0 +1,96 @@
+/*
+  DataSession.h - Selective repeat download of the SEND DATA frames
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DATA_SESSION_H
+#define DATA_SESSION_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// After SEND DATA the satellite sends a window of up to SEQ_SPACE frames,
+// numbered by their byte 3. A round ends when the last frame still missing
+// arrives, or after the configured silence, and is answered with ACK DATA:
+// one byte per frame of the window, 1 when it was received, so only the
+// missing ones are sent again. A transfer that stops progressing is kept in
+// NVS and the next SEND DATA on the same satellite asks for what is missing
+// instead of starting over.
+class DataSession {
+public:
+  static DataSession& getInstance()
+  {
+    static DataSession instance;
+    return instance;
+  }
+  static const uint8_t SEQ_SPACE = 20; // slots in the ACK DATA TC
+
+  bool resume();
+  void start();
+  bool active() { return running; }
+  void onFrame(const uint8_t* frame, size_t length);
+  void loop();
+
+private:
+  DataSession();
+  struct Stored {
+    uint32_t magic;
+    uint32_t norad;
+    uint32_t started;     // unix time of the first SEND DATA
+    uint32_t received;    // bitmap of the window
+    uint8_t window;
+    uint8_t rounds;
+  };
+
+  struct Ack {
+    uint8_t tc[2 + 1 + SEQ_SPACE + 4]; // header, opcode, one byte per slot, unix time
+    uint8_t received;
+    uint8_t window;
+  };
+  enum Persist : uint8_t { PERSIST_NONE, PERSIST_SAVE, PERSIST_CLEAR };
+
+  bool complete() { return received == windowMask(); }
+  uint32_t windowMask() { return window >= 32 ? 0xFFFFFFFF : (1u << window) - 1; }
+  uint8_t lastMissing();
+  void closeRound(Ack& ack);
+  void buildAck(Ack& ack);
+  bool sendAck(const Ack& ack);
+  void save(const Stored& stored);
+  void clear();
+
+  static const uint32_t MAGIC = 0x51524154;  // "TARQ"
+  static const uint8_t ACK_OPCODE = 0x18;
+  static const uint8_t MAX_IDLE_ROUNDS = 3;  // rounds without a new frame before it is left for the next pass
+  static const uint32_t RESUME_AGE = 24 * 3600; // s, older transfers start over
+
+  // Guards the session state only. It is never held while calling into the
+  // radio or NVS, the FEC task takes it from onFrame()
+  SemaphoreHandle_t mutex;
+  Preferences prefs;           // main loop only, see loop()
+  bool running = false;
+  Persist pending = PERSIST_NONE;
+  uint8_t window = SEQ_SPACE;
+  uint32_t received = 0;
+  uint32_t started = 0;
+  uint8_t rounds = 0;
+  uint8_t idleRounds = 0;
+  bool progress = false;       // a new frame arrived in this round
+  uint8_t roundLast = 0;       // the frame that closes the round
+  unsigned long lastFrame = 0; // millis() of the last frame, or of the last request
+};
+
+#endif
@@ -0,0 +1,101 @@
+/*
+  Doppler.cpp - Doppler tracking of the satellite during a pass
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Doppler.h"
+#include "Radio.h"
+#include "../Orbit/Orbit.h"
+#include "../Logger/Logger.h"
+
+double Doppler::nominalFrequency()
+{
+  return status.modeminfo.frequency + status.modeminfo.freqOffset;
+}
+
+// The radio was retuned to the nominal frequency, by begin() or a remote command
+void Doppler::reset()
+{
+  RadioLock lock;
+  tracking = false;
+  bias = 0;
+  predicted = 0;
+}
+
+void Doppler::loop()
+{
+  if (millis() - lastUpdate < UPDATE_INTERVAL)
+    return;
+  lastUpdate = millis();
+
+  Orbit& orbit = Orbit::getInstance();
+  Radio& radio = Radio::getInstance();
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  LookAngles angles;
+  bool inView = orbit.valid() && radio.isReady() && !radio.isSleeping() &&
+                orbit.look(tv.tv_sec + tv.tv_usec / 1e6, angles) && angles.elevation >= HORIZON;
+
+  RadioLock lock;
+  if (!tracking)
+  {
+    if (!inView)
+      return;
+    nominal = nominalFrequency();
+    tuned = nominal;
+    bias = 0;
+    tracking = true;
+    Log::console(PSTR("Doppler tracking %s, elevation %.1f deg"), status.modeminfo.satellite, angles.elevation);
+  }
+
+  if (!inView)
+  {
+    // back on the nominal frequency for whatever comes next, once the radio is free
+    if (!radio.isReady() || radio.isSleeping() || radio.retune(nominal))
+    {
+      tracking = false;
+      Log::console(PSTR("Doppler tracking stopped, bias %.0f Hz"), bias * 1e6);
+    }
+    return;
+  }
+
+  nominal = nominalFrequency();
+  predicted = -nominal * angles.rangeRate / SPEED_OF_LIGHT;
+  double frequency = nominal + predicted + bias;
+  if (fabs(frequency - tuned) * 1e6 < RETUNE_STEP)
+    return;
+  if (radio.retune(frequency))
+  {
+    tuned = frequency;
+    Log::debug(PSTR("Doppler %.0f Hz, bias %.0f Hz"), predicted * 1e6, bias * 1e6);
+  }
+}
+
+// A frame received correctly while tracking, with the error the modem measured
+// (signal minus carrier). Called by the RX task with the radio locked.
+void Doppler::onFrame(float frequencyError)
+{
+  if (!tracking)
+    return;
+  double residual = tuned + frequencyError / 1e6 - nominal - predicted;
+  if (fabs(residual - bias) > status.modeminfo.bw * 1e-3 * MAX_INNOVATION)
+  {
+    Log::console(PSTR("Frequency error of %.0f Hz ignored by the Doppler loop"), frequencyError);
+    return;
+  }
+  bias += BIAS_GAIN * (residual - bias);
+}
@@ -0,0 +1,64 @@
+/*
+  Doppler.h - Doppler tracking of the satellite during a pass
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef DOPPLER_H
+#define DOPPLER_H
+
+#include <Arduino.h>
+
+// While the tracked satellite is in view the receiver follows the shift the
+// orbit predicts, plus a bias learnt from the frequency error the modem
+// measures on every good frame (the satellite oscillator and whatever the
+// model gets wrong). Transmissions are moved the opposite way, so the
+// satellite hears them on its own frequency.
+class Doppler {
+public:
+  static Doppler& getInstance()
+  {
+    static Doppler instance;
+    return instance;
+  }
+
+  void loop();
+  void reset();
+  void onFrame(float frequencyError);
+  bool active() { return tracking; }
+  double rxFrequency() { return tuned; }
+  double txFrequency() { return nominal - predicted + bias; }
+
+private:
+  Doppler() {};
+  double nominalFrequency();
+
+  static const uint32_t UPDATE_INTERVAL = 250;   // ms
+  static constexpr float HORIZON = -3;           // deg, tracking starts a little before AOS
+  static constexpr double SPEED_OF_LIGHT = 299792.458; // km/s
+  static constexpr float RETUNE_STEP = 61;       // Hz, one step of the SX127x synthesizer
+  static constexpr float BIAS_GAIN = 0.25;       // weight of a new measurement
+  static constexpr float MAX_INNOVATION = 0.25;  // of the bandwidth, larger errors are not the satellite
+
+  volatile bool tracking = false;
+  unsigned long lastUpdate = 0;
+  double nominal = 0;     // MHz, modem frequency plus offset
+  double tuned = 0;       // MHz, carrier the receiver is on
+  double predicted = 0;   // MHz, shift from the range rate
+  double bias = 0;        // MHz, measured residual
+};
+
+#endif
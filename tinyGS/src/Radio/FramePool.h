@@ -0,0 +1,62 @@
+/*
+  FramePool.h - Fixed pool of received frame buffers
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// COUNT buffers allocated once, handed out and taken back without touching the
+// heap. A frame is acquired by the RX task, decoded in place and released by
+// whoever is done with it last, the decoder or the main loop, so the in-use
+// bitmap is updated with atomic operations from any task.
+template <typename T, size_t COUNT>
+class FramePool {
+public:
+  static_assert(COUNT > 0 && COUNT < 32, "the in-use bitmap is one 32-bit word");
+
+  T* acquire()
+  {
+    uint32_t used = inUse.load(std::memory_order_relaxed);
+    for (;;)
+    {
+      if (used == ALL)
+        return nullptr;
+      uint32_t bit = ~used & (used + 1); // lowest free buffer
+      if (inUse.compare_exchange_weak(used, used | bit, std::memory_order_acquire, std::memory_order_relaxed))
+        return &frames[__builtin_ctz(bit)];
+    }
+  }
+
+  void release(T* frame)
+  {
+    inUse.fetch_and(~(1u << (frame - frames)), std::memory_order_release);
+  }
+
+  size_t available() const { return COUNT - __builtin_popcount(inUse.load(std::memory_order_relaxed)); }
+
+private:
+  static const uint32_t ALL = (1u << COUNT) - 1;
+  std::atomic<uint32_t> inUse {0};
+  T frames[COUNT];
+};
+
+#endif
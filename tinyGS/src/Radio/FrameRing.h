@@ -0,0 +1,64 @@
+/*
+  FrameRing.h - Lock-free queue of received frames between the RX task and the decoder
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef FRAME_RING_H
+#define FRAME_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+
+// Single producer, single consumer queue of T, the RX task hands frame
+// pointers to the decoder through it. Each index is written by one side only
+// and never wraps back, so no lock is needed, the release stores publish the
+// element written before them.
+template <typename T, size_t SLOTS>
+class FrameRing {
+public:
+  static_assert((SLOTS & (SLOTS - 1)) == 0, "SLOTS must be a power of two");
+
+  bool push(const T& item)
+  {
+    uint32_t h = head.load(std::memory_order_relaxed);
+    if (h - tail.load(std::memory_order_acquire) == SLOTS)
+      return false;
+    slots[h % SLOTS] = item;
+    head.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop(T& item)
+  {
+    uint32_t t = tail.load(std::memory_order_relaxed);
+    if (head.load(std::memory_order_acquire) == t)
+      return false;
+    item = slots[t % SLOTS];
+    tail.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  size_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+
+private:
+  std::atomic<uint32_t> head {0};
+  std::atomic<uint32_t> tail {0};
+  T slots[SLOTS];
+};
+
+#endif
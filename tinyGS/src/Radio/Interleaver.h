@@ -0,0 +1,74 @@
+/*
+  Interleaver.h - Block interleaver driven by compile-time permutation tables
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef INTERLEAVER_H
+#define INTERLEAVER_H
+
+#include <stdint.h>
+#include <string.h>
+
+// The frame is written into each ROWS x COLS block column by column and sent
+// row by row, so a burst on air is spread over the whole block once deinterleaved.
+// Both directions are a single gather through a table built by the compiler.
+
+template <size_t... I> struct IndexSeq {};
+template <size_t N, size_t... I> struct MakeIndexSeq : MakeIndexSeq<N - 1, N - 1, I...> {};
+template <size_t... I> struct MakeIndexSeq<0, I...> { typedef IndexSeq<I...> type; };
+
+template <size_t ROWS, size_t COLS, typename Seq = typename MakeIndexSeq<ROWS * COLS>::type>
+struct BlockInterleaver;
+
+template <size_t ROWS, size_t COLS, size_t... I>
+struct BlockInterleaver<ROWS, COLS, IndexSeq<I...>>
+{
+  static const size_t BLOCK = ROWS * COLS;
+  static_assert(BLOCK <= 256, "permutation tables hold 8-bit indexes");
+
+  // position in the interleaved block of the byte that lands at j once deinterleaved
+  static constexpr uint8_t deinterleaveSource(size_t j) { return (j % COLS) * ROWS + j / COLS; }
+  // and the inverse, position in the plain block of interleaved byte k
+  static constexpr uint8_t interleaveSource(size_t k) { return (k % ROWS) * COLS + k / ROWS; }
+
+  static const uint8_t deinterleaveTable[BLOCK];
+  static const uint8_t interleaveTable[BLOCK];
+
+  // length must be a whole number of blocks, any remainder is left untouched
+  static void deinterleave(uint8_t* data, size_t length) { permute(data, length, deinterleaveTable); }
+  static void interleave(uint8_t* data, size_t length) { permute(data, length, interleaveTable); }
+
+private:
+  static void permute(uint8_t* data, size_t length, const uint8_t* table)
+  {
+    uint8_t block[BLOCK];
+    for (size_t base = 0; base + BLOCK <= length; base += BLOCK)
+    {
+      memcpy(block, data + base, BLOCK);
+      for (size_t j = 0; j < BLOCK; j++)
+        data[base + j] = block[table[j]];
+    }
+  }
+};
+
+template <size_t ROWS, size_t COLS, size_t... I>
+const uint8_t BlockInterleaver<ROWS, COLS, IndexSeq<I...>>::deinterleaveTable[] = { deinterleaveSource(I)... };
+
+template <size_t ROWS, size_t COLS, size_t... I>
+const uint8_t BlockInterleaver<ROWS, COLS, IndexSeq<I...>>::interleaveTable[] = { interleaveSource(I)... };
+
+#endif
@@ -18,6 +18,8 @@
 */
 
 #include "Radio.h"
+#include "Interleaver.h"
+#include "Telecommands.h"
 #include "correct/rs/ecc.h"
 #include "correct/reed-solomon.h"
 #include "correct/convolutional.h"
@@ -27,24 +29,46 @@
 #endif
 #include <base64.h>
 #include "../Logger/Logger.h"
-#include <chrono>
+#include "DataSession.h"
+#include "Doppler.h"
+#include <atomic>
 #include <sstream>
+#include <esp_timer.h>
+#include <sys/time.h>
 
-bool send_data = false;
 bool send_config = false;
 bool send_telemetry = false;
-bool received = false;
+static TaskHandle_t rxTaskHandle = nullptr; // woken by the DIO interrupt
+static TaskHandle_t fecTaskHandle = nullptr; // woken by the RX task for every queued frame
+static volatile int64_t rxIrqTime = 0;       // esp_timer_get_time() of the last DIO interrupt
+static std::atomic<bool> irqPending {false};  // the RX task is also woken to send queued frames
+static volatile bool txActive = false;        // the next interrupt is TX done
 bool eInterrupt = true;
 bool noisyInterrupt = false;
-int last_data_packet;
+// RS decoder workspace sized for the largest code we accept, never touches the heap
+static uint8_t rsWorkspace[CORRECT_RS_WORKSPACE_SIZE(MIN_DISTANCE_RS)] __attribute__((aligned(8)));
 
 Radio::Radio()
     : spi(VSPI)
 {
+  radioMutex = xSemaphoreCreateRecursiveMutex();
+  fecMutex = xSemaphoreCreateMutex();
+}
+
+void Radio::lock()
+{
+  xSemaphoreTakeRecursive(radioMutex, portMAX_DELAY);
+}
+
+void Radio::unlock()
+{
+  xSemaphoreGiveRecursive(radioMutex);
 }
 
 void Radio::init()
 {
+  initCodecs();
+
   Log::console(PSTR("[SX12xx] Initializing ... "));
   board_type board;
 
@@ -54,11 +78,8 @@ void Radio::init()
     DynamicJsonDocument doc(size);
     DeserializationError error = deserializeJson(doc, ConfigManager::getInstance().getBoardTemplate());
     
-    send_data = false;
     send_config = false;
     send_telemetry = false;
-    last_data_packet = 0;
-    std::chrono::high_resolution_clock::now();
 
     if (error.code() != DeserializationError::Ok || !doc.containsKey("radio"))
     {
@@ -99,12 +120,103 @@ void Radio::init()
     lora = new SX1268(new Module(board.L_NSS, board.L_DI01, board.L_RST, board.L_BUSSY, spi, SPISettings(2000000, MSBFIRST, SPI_MODE0)));
   }
 
+  // the interrupt only wakes these tasks, they have to exist before the radio starts receiving.
+  // Both stay on the radio core, the network task runs MQTT and the web panel on the other one
+  if (!rxTaskHandle)
+  {
+    reportQueue = xQueueCreate(REPORT_QUEUE_DEPTH, sizeof(RxFrame*));
+    xTaskCreatePinnedToCore(fecTask, "radioFec", FEC_TASK_STACK, this, FEC_TASK_PRIORITY, &fecTaskHandle, RADIO_CORE);
+    xTaskCreatePinnedToCore(rxTask, "radioRx", RX_TASK_STACK, this, RX_TASK_PRIORITY, &rxTaskHandle, RADIO_CORE);
+  }
+
   begin();
 }
 
+void Radio::initCodecs()
+{
+  if (codecs.ready)
+    return;
+
+  uint32_t heapBefore = ESP.getFreeHeap();
+  uint32_t start = micros();
+
+  initialize_ecc();
+  codecs.conv = correct_convolutional_create(RATE_CON, ORDER_CON, correct_conv_r12_7_polynomial);
+  configureFec();
+
+  codecs.buildTime = micros() - start;
+  codecs.heapUsed = heapBefore - ESP.getFreeHeap();
+  codecs.ready = codecs.conv && (codecs.rs || !codecs.rsParity);
+
+  if (codecs.ready)
+    Log::console(PSTR("[FEC] Codecs ready in %u us, %u bytes of heap"), codecs.buildTime, codecs.heapUsed);
+  else
+    Log::error(PSTR("[FEC] Unable to allocate codecs!"));
+}
+
+// Copies the frame layout of the modem config for the RX decoder. The FEC task
+// decodes RS under the same mutex, so the workspace is never rebuilt under it
+void Radio::configureFec()
+{
+  xSemaphoreTake(fecMutex, portMAX_DELAY);
+  ModemInfo &m = status.modeminfo;
+  codecs.convolutional = m.conv;
+  codecs.interleaverDepth = m.interleaverDepth;
+  codecs.lengthHeader = m.lengthHeader;
+  configureRs();
+  xSemaphoreGive(fecMutex);
+}
+
+FecLayout Radio::fecLayout()
+{
+  xSemaphoreTake(fecMutex, portMAX_DELAY);
+  FecLayout layout = {codecs.convolutional, codecs.interleaverDepth, codecs.lengthHeader, codecs.rsParity};
+  xSemaphoreGive(fecMutex);
+  return layout;
+}
+
+// (Re)build the RX Reed-Solomon decoder only when the modem config asks for a different code.
+// FEC mutex held
+void Radio::configureRs()
+{
+  ModemInfo &m = status.modeminfo;
+  if (codecs.rs && codecs.rsCcsds == m.rsCcsds && codecs.rsParity == m.rsParity)
+    return;
+
+  codecs.rs = nullptr; // it lives in rsWorkspace, nothing to free
+  codecs.rsCcsds = m.rsCcsds;
+  codecs.rsParity = m.rsParity;
+
+  if (!m.rsParity)
+  {
+    Log::console(PSTR("[FEC] Reed-Solomon disabled"));
+    return;
+  }
+
+  if (m.rsCcsds)
+    codecs.rs = correct_reed_solomon_create_in(rsWorkspace, sizeof(rsWorkspace), correct_rs_primitive_polynomial_ccsds, 1, 1, MIN_DISTANCE_RS, nullptr);
+  else // same code as the rscode TC encoder when rsParity == NPAR, its tables are in flash
+    codecs.rs = correct_reed_solomon_create_in(rsWorkspace, sizeof(rsWorkspace), correct_rs_primitive_polynomial_8_4_3_2_0, 1, 1, m.rsParity,
+                                               m.rsParity == correct_rs_tables_8_4_3_2_0_6.num_roots ? &correct_rs_tables_8_4_3_2_0_6 : nullptr);
+
+  if (!codecs.rs)
+  {
+    Log::error(PSTR("[FEC] Unable to build Reed-Solomon with %u parity bytes"), m.rsParity);
+    return;
+  }
+
+  Log::console(PSTR("[FEC] Reed-Solomon %s, %u parity bytes"), m.rsCcsds ? "CCSDS" : "shortened", m.rsParity);
+}
+
 int16_t Radio::begin()
 {
+  RadioLock lock;
   status.radio_ready = false;
+  sleeping = false;
+  Doppler::getInstance().reset();
+  if (codecs.conv)
+    configureFec();
+
   board_type board = ConfigManager::getInstance().getBoardConfig();
   ModemInfo &m = status.modeminfo;
   int16_t state = 0;
@@ -208,15 +320,179 @@ int16_t Radio::begin()
   return state;
 }
 
-void Radio::setFlag()
+void IRAM_ATTR Radio::setFlag()
 {
-  if (received || !eInterrupt)
+  if ((!eInterrupt && !txActive) || !rxTaskHandle)
+  {
     noisyInterrupt = true;
+    return;
+  }
+
+  rxIrqTime = esp_timer_get_time();
+  irqPending = true;
+  BaseType_t woken = pdFALSE;
+  vTaskNotifyGiveFromISR(rxTaskHandle, &woken);
+  if (woken)
+  {
+    portYIELD_FROM_ISR();
+  }
+}
+
+// Drains the radio as soon as the interrupt fires, so the next packet can be
+// received while the main loop is still decoding or publishing this one.
+// It also owns transmissions, it sleeps until the next queued frame is due
+// and the radio is back to listening between frames
+void Radio::rxTask(void* param)
+{
+  Radio* radio = (Radio*)param;
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, radio->txWait());
+    if (irqPending.exchange(false))
+    {
+      if (txActive)
+        radio->finishTx();
+      else
+        radio->readFrame();
+    }
+    radio->serviceTx();
+  }
+}
+
+void Radio::startReceive()
+{
+  RadioLock lock;
+  // put module back to listen mode
+  if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
+    ((SX1278 *)lora)->startReceive();
+  else
+    ((SX1268 *)lora)->startReceive();
+}
+
+void Radio::readFrame()
+{
+  RadioLock lock;
+  RxFrame* frame = rxPool.acquire();
+  if (!frame)
+  {
+    // every buffer is still being decoded or published, this frame is lost
+    status.rxQueue.poolExhausted++;
+    noisyInterrupt = true;
+    startReceive();
+    return;
+  }
+
+  // the FIFO is read straight into the pooled buffer, the length comes from the radio and is bounded by it
+  frame->frequencyerror = 0;
+  frame->crc_error = false;
+  frame->rs_corrected = 0;
+  if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
+  {
+    SX1278 *l = (SX1278 *)lora;
+    frame->length = l->getPacketLength();
+    if (frame->length > RX_FRAME_SIZE)
+      frame->length = RX_FRAME_SIZE;
+    frame->state = l->readData(frame->data, frame->length);
+    frame->rssi = l->getRSSI();
+    frame->snr = l->getSNR();
+    frame->frequencyerror = l->getFrequencyError();
+    if (frame->state == ERR_NONE)
+      Doppler::getInstance().onFrame(frame->frequencyerror);
+  }
+  else
+  {
+    SX1268 *l = (SX1268 *)lora;
+    frame->length = l->getPacketLength();
+    if (frame->length > RX_FRAME_SIZE)
+      frame->length = RX_FRAME_SIZE;
+    frame->state = l->readData(frame->data, frame->length);
+    frame->rssi = l->getRSSI();
+    frame->snr = l->getSNR();
+  }
+  frame->noisy = noisyInterrupt;
+  // the interrupt was stamped on the monotonic timer, it is moved to the wall
+  // clock here, close enough to it that an NTP step in between is unlikely
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  frame->irqTime = rxIrqTime;
+  frame->irqUnixUsec = (int64_t)tv.tv_usec + tv.tv_sec * 1000000ll - (esp_timer_get_time() - frame->irqTime);
+  noisyInterrupt = false;
+  rxRing.push(frame); // never full, it has a slot for every pooled buffer
+  xTaskNotifyGive(fecTaskHandle);
+
+  uint8_t depth = rxRing.size();
+  if (depth > status.rxQueue.depthMax)
+    status.rxQueue.depthMax = depth;
+
+  startReceive();
+}
+
+// Decodes every frame the RX task has queued, on the radio core so the
+// network side can block without holding the radio back
+void Radio::fecTask(void* param)
+{
+  Radio* radio = (Radio*)param;
+  for (;;)
+  {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    while (radio->listen() != 1)
+      ;
+  }
+}
 
-  if (!eInterrupt)
+void Radio::queueReport(RxFrame* frame)
+{
+  if (xQueueSend(reportQueue, &frame, 0) != pdTRUE)
+  {
+    status.rxQueue.reportsDropped++;
+    Log::console(PSTR("Report queue full, frame dropped"));
+    rxPool.release(frame);
     return;
+  }
 
-  received = true;
+  uint8_t depth = uxQueueMessagesWaiting(reportQueue);
+  if (depth > status.rxQueue.reportDepthMax)
+    status.rxQueue.reportDepthMax = depth;
+}
+
+// Called from the main loop, takes the next decoded frame and makes it the
+// last packet shown by the status, display and web panel. The caller owns the
+// frame until it hands it back with releaseFrame()
+RxFrame* Radio::takeFrame()
+{
+  RxFrame* frame;
+  if (!reportQueue || xQueueReceive(reportQueue, &frame, 0) != pdTRUE)
+    return nullptr;
+
+  status.lastPacketInfo.rssi = frame->rssi;
+  status.lastPacketInfo.snr = frame->snr;
+  status.lastPacketInfo.frequencyerror = frame->frequencyerror;
+  status.lastPacketInfo.crc_error = frame->crc_error;
+  status.lastPacketInfo.rs_corrected = frame->rs_corrected;
+
+  status.rxQueue.latency = (esp_timer_get_time() - frame->irqTime) / 1000;
+  if (status.rxQueue.latency > status.rxQueue.latencyMax)
+    status.rxQueue.latencyMax = status.rxQueue.latency;
+
+  // store time of the last packet received
+  time_t currenttime = time(NULL);
+  if (currenttime < 0)
+  {
+    Log::error(PSTR("Failed to obtain time"));
+    status.lastPacketInfo.time[0] = '\0';
+  }
+  else
+  {
+    struct tm *timeinfo = localtime(&currenttime);
+    snprintf(status.lastPacketInfo.time, sizeof(status.lastPacketInfo.time), "%d:%02d:%02d", timeinfo->tm_hour, timeinfo->tm_min, timeinfo->tm_sec);
+  }
+
+  return frame;
+}
+
+void Radio::releaseFrame(RxFrame* frame)
+{
+  rxPool.release(frame);
 }
 
 void Radio::enableInterrupt()
@@ -231,250 +507,335 @@ void Radio::disableInterrupt()
 
 void Radio::startRx()
 {
-  // put module back to listen mode
-  if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
-    ((SX1278 *)lora)->startReceive();
-  else
-    ((SX1268 *)lora)->startReceive();
+  startReceive();
 
   // we're ready to receive more packets,
   // enable interrupt service routine
   enableInterrupt();
 }
 
-int16_t Radio::sendTx(uint8_t *data, size_t length)
+// Queues a frame for the RX task to send, it returns right away
+int16_t Radio::sendTx(const uint8_t *data, size_t length, uint8_t copies, uint32_t spacing)
 {
   if (!ConfigManager::getInstance().getAllowTx())
   {
     Log::error(PSTR("TX disabled by config"));
     return -1;
   }
-  disableInterrupt();
+  if (!status.radio_ready || sleeping)
+    return -1;
+  if (length > sizeof(TxFrame::data))
+    return ERR_PACKET_TOO_LONG;
 
-  // send data
-  int16_t state = 0;
+  TxFrame* frame = txPool.acquire();
+  if (!frame)
+  {
+    Log::error(PSTR("TX queue full, frame dropped"));
+    return -1;
+  }
+  memcpy(frame->data, data, length);
+  frame->length = length;
+  frame->copies = copies ? copies : 1;
+  frame->spacing = spacing;
+  {
+    RadioLock lock; // the ring has a single producer, the lock makes every caller one
+    txRing.push(frame); // never full, it has a slot for every pooled frame
+  }
+  xTaskNotifyGive(rxTaskHandle);
+  return ERR_NONE;
+}
+
+// Starts the next queued frame once its spacing has passed, on the RX task
+void Radio::serviceTx()
+{
+  RadioLock lock;
+  int64_t now = esp_timer_get_time();
+  if (txActive)
+  {
+    if (now - txStarted > TX_TIMEOUT)
+    {
+      // TX done never came, the radio is taken back to listening
+      Log::error(PSTR("TX timeout, frame dropped"));
+      txActive = false;
+      txEnded = now;
+      txPool.release(txFrame);
+      txFrame = nullptr;
+      restoreCarrier();
+      startReceive();
+    }
+    return;
+  }
+
+  if (!txFrame)
+  {
+    if (!txRing.pop(txFrame))
+      return;
+    txCopiesSent = 0;
+  }
+  // a packet that arrived meanwhile is read before the FIFO is overwritten
+  if (now < txEnded + txFrame->spacing || irqPending)
+    return;
+
+  txActive = true;
+  txStarted = now;
+  // uplink Doppler, the satellite hears the frame on its own frequency
+  if (Doppler::getInstance().active())
+  {
+    setCarrier(Doppler::getInstance().txFrequency());
+    txCorrected = true;
+  }
+  int16_t state;
+  if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
+    state = ((SX1278 *)lora)->startTransmit(txFrame->data, txFrame->length);
+  else
+    state = ((SX1268 *)lora)->startTransmit(txFrame->data, txFrame->length);
+
+  if (state != ERR_NONE)
+  {
+    Log::error(PSTR("TX failed, code %d"), state);
+    txActive = false;
+    txPool.release(txFrame);
+    txFrame = nullptr;
+    restoreCarrier();
+    startReceive();
+  }
+}
+
+// The interrupt while transmitting, the radio goes back to RX until the next frame
+void Radio::finishTx()
+{
+  RadioLock lock;
+  bool done;
   if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
   {
     SX1278 *l = (SX1278 *)lora;
-    state = l->transmit(data, length);
-    l->setDio0Action(setFlag);
-    l->startReceive();
+    uint16_t flags = l->getIRQFlags();
+    done = l->getActiveModem() == SX127X_LORA ? flags & SX127X_CLEAR_IRQ_FLAG_TX_DONE : (flags >> 8) & SX127X_FLAG_PACKET_SENT;
   }
   else
+    done = ((SX1268 *)lora)->getIrqStatus() & SX126X_IRQ_TX_DONE;
+  if (!done)
+    return; // a reception that ended just as the transmission started
+
+  txActive = false;
+  txEnded = esp_timer_get_time();
+  if (++txCopiesSent >= txFrame->copies)
   {
-    SX1268 *l = (SX1268 *)lora;
-    state = l->transmit(data, length);
-    l->setDio1Action(setFlag);
-    l->startReceive();
+    txPool.release(txFrame);
+    txFrame = nullptr;
   }
-
-  enableInterrupt();
-  return state;
+  restoreCarrier();
+  startReceive();
 }
 
-int16_t Radio::sendTestPacket()
+// Carrier for the next transmission, the radio is in standby between frames
+void Radio::setCarrier(double frequency)
 {
-  return sendTx((uint8_t *)TEST_STRING, strlen(TEST_STRING));
+  if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
+    ((SX1278 *)lora)->setFrequencyRaw(frequency);
+  else
+    ((SX1268 *)lora)->setFrequencyRaw(frequency);
 }
 
-uint8_t Radio::listen()
+// Back to the receive carrier after a corrected transmission
+void Radio::restoreCarrier()
 {
-  // check if the flag is set (received interruption)
-  if (!received)
-    return 1;
-
-  // disable the interrupt service routine while
-  // processing the data
-  disableInterrupt();
-
-  // reset flag
-  received = false;
+  if (!txCorrected)
+    return;
+  txCorrected = false;
+  setCarrier(Doppler::getInstance().rxFrequency());
+}
 
-  size_t respLen = 0;
-  uint8_t *respFrame = 0;
-  int16_t state = 0;
+// Moves the receiver to frequency MHz without the sleep setFrequency needs.
+// FRF is only written in standby, so it is done in the gap between frames:
+// false while a frame is being received or sent, it is tried again later.
+bool Radio::retune(double frequency)
+{
+  RadioLock lock;
+  if (txActive || irqPending || sleeping)
+    return false;
 
-  PacketInfo newPacketInfo;
-  status.lastPacketInfo.crc_error = 0;
-  // read received data
   if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
   {
     SX1278 *l = (SX1278 *)lora;
-    respLen = l->getPacketLength();
-    respFrame = new uint8_t[respLen];
-    state = l->readData(respFrame, respLen);
-    newPacketInfo.rssi = l->getRSSI();
-    newPacketInfo.snr = l->getSNR();
-    newPacketInfo.frequencyerror = l->getFrequencyError();
+    // LoRa signal detected, synchronized or header valid, or the FSK sync word matched
+    if (l->getActiveModem() == SX127X_LORA ? l->getModemStatus() & 0x0B : l->getIRQFlags() & SX127X_FLAG_SYNC_ADDRESS_MATCH)
+      return false;
+    l->setFrequencyRaw(frequency); // standby, then FRF
+    l->startReceive();
   }
   else
   {
     SX1268 *l = (SX1268 *)lora;
-    respLen = l->getPacketLength();
-    respFrame = new uint8_t[respLen];
-    state = l->readData(respFrame, respLen);
-    newPacketInfo.rssi = l->getRSSI();
-    newPacketInfo.snr = l->getSNR();
+    l->standby();
+    l->setFrequencyRaw(frequency);
+    l->startReceive();
   }
+  return true;
+}
+
+// Modem to sleep between passes, begin() wakes it up
+bool Radio::sleep()
+{
+  RadioLock lock;
+  if (txActive || txFrame || txRing.size())
+    return false; // queued frames go out first
+
+  int16_t state;
+  if (ConfigManager::getInstance().getBoardConfig().L_SX127X)
+    state = ((SX1278 *)lora)->sleep();
+  else
+    state = ((SX1268 *)lora)->sleep();
+  sleeping = state == ERR_NONE;
+  return sleeping;
+}
+
+// How long the RX task can sleep before a queued frame is due
+TickType_t Radio::txWait()
+{
+  int64_t due;
+  if (txActive)
+    due = txStarted + TX_TIMEOUT;
+  else if (txFrame)
+    due = txEnded + txFrame->spacing;
+  else if (txRing.size())
+    return 0;
+  else
+    return portMAX_DELAY;
+
+  int64_t wait = due - esp_timer_get_time();
+  if (wait <= 0)
+    return 0;
+  return (wait + portTICK_PERIOD_MS * 1000 - 1) / (portTICK_PERIOD_MS * 1000);
+}
+
+int16_t Radio::sendTestPacket()
+{
+  return sendTx((uint8_t *)TEST_STRING, strlen(TEST_STRING));
+}
+
+uint8_t Radio::listen()
+{
+  // take the oldest frame queued by the RX task, every stage below works in place on its buffer
+  RxFrame* frame;
+  if (!rxRing.pop(frame))
+    return 1;
+
+  size_t respLen = frame->length;
+  int16_t state = frame->state;
+  uint8_t* rxFrame = frame->data;
 
   // check if the packet info is exactly the same as the last one
-  if (newPacketInfo.rssi == status.lastPacketInfo.rssi &&
-      newPacketInfo.snr == status.lastPacketInfo.snr &&
-      newPacketInfo.frequencyerror == status.lastPacketInfo.frequencyerror)
+  if (frame->rssi == lastRssi &&
+      frame->snr == lastSnr &&
+      frame->frequencyerror == lastFrequencyError)
   {
     Log::console(PSTR("Interrupt triggered but no new data available. Check wiring and electrical interferences."));
-    delete[] respFrame;
-    startRx();
+    rxPool.release(frame);
     return 4;
   }
 
-  status.lastPacketInfo.rssi = newPacketInfo.rssi;
-  status.lastPacketInfo.snr = newPacketInfo.snr;
-  status.lastPacketInfo.frequencyerror = newPacketInfo.frequencyerror;
+  lastRssi = frame->rssi;
+  lastSnr = frame->snr;
+  lastFrequencyError = frame->frequencyerror;
 
   // print RSSI (Received Signal Strength Indicator)
-  Log::console(PSTR("[SX12x8] RSSI:\t\t%f dBm\n[SX12x8] SNR:\t\t%f dB\n[SX12x8] Frequency error:\t%f Hz"), status.lastPacketInfo.rssi, status.lastPacketInfo.snr, status.lastPacketInfo.frequencyerror);
-  
-  
-  // initialize static variable with current time
-  static auto lastTime = std::chrono::high_resolution_clock::now();
-  auto currentTime = std::chrono::high_resolution_clock::now();
-  //compute time since last packet received
-  auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - lastTime);
-  // update lastTime with current time for the next call
-  lastTime = currentTime;
+  Log::console(PSTR("[SX12x8] RSSI:\t\t%f dBm\n[SX12x8] SNR:\t\t%f dB\n[SX12x8] Frequency error:\t%f Hz"), frame->rssi, frame->snr, frame->frequencyerror);
   
 
   if (state == ERR_NONE && respLen > 0)
   { 
     // read optional data
     Log::console(PSTR("Packet received (%u bytes):"), respLen);
-    uint16_t buffSize = respLen * 3 + 1;
-    if (buffSize > 255)
-      buffSize = 255;
-    char *rx_str = new char[buffSize];
-    for (int i = 0; i < respLen; i++)
-    {
-      sprintf(rx_str + i * 3 % (buffSize - 1), "%02x ", respFrame[i]);
-      if (i * 3 % buffSize == buffSize - 3 || i == respLen - 1)
-        Log::console(PSTR("%s"), rx_str); // print before the buffer is going to loop back
-    }
+    logHex(rxFrame, respLen);
 
-    /* 
-    //read convolution decoded
-    int index = ceil(respLen/RATE_CON);
-    Log::console(PSTR("Packet convolution decoded (%u bytes):"), index);
-    char *rx_str_deconv = new char[buffSize];
-    uint8_t data_deconv[respLen];
-    memcpy(data_deconv,respFrame,respLen);
-    decode_conv(data_deconv,respLen);
-    for (int i = 0; i < index; i++)
-    {
-      sprintf(rx_str_deconv + i * 3 % (buffSize - 1), "%02x ", data_deconv[i]);
-      if (i * 3 % buffSize == buffSize - 3 || i == index - 1)
-        Log::console(PSTR("%s"), rx_str_deconv); // print before the buffer is going to loop back
-    }
-    */
+    // the whole pipeline is timed in cycles
+    uint32_t pipelineStart = ESP.getCycleCount();
 
+    // every stage decodes with the layout of the config the frame arrived with,
+    // without the radio lock so the RX task keeps draining the radio meanwhile
+    const FecLayout fec = fecLayout();
 
-  
-    //send_data ack  
-    
-    if (send_data){
-      if (last_data_packet == 0){
-        //add the correct received packets to the ack_data vector
-        ACK_DATA_TC[0] = 0xC8;
-        ACK_DATA_TC[1] = 0x9D;
-        ACK_DATA_TC[2] = 0x18;
+    //soft-decision viterbi, the coded bits lost with the tail of the frame are
+    //decoded as erasures instead of guessed, so the frame keeps its full length
+    if (fec.conv && codecs.ready)
+    {
+      // whole interleaver blocks plus the K+1 flush bits (2 bytes coded), at rate 1/2
+      const size_t convBlock = interleaverBlock(fec.interleaverDepth);
+      size_t blocks = respLen > 2 ? (respLen - 2 + 2 * convBlock - 1) / (2 * convBlock) : 1;
+      size_t codedBits = (blocks * convBlock * 8 + ORDER_CON + 1) * RATE_CON;
+      ssize_t decodedLen = decode_conv_soft(rxFrame, respLen, codedBits, nullptr, rxFrame, RX_FRAME_SIZE);
+      if (decodedLen > 0)
+      {
+        respLen = (size_t)decodedLen > blocks * convBlock ? blocks * convBlock : decodedLen;
+        Log::console(PSTR("Packet convolution decoded (%u bytes)"), respLen);
       }
-      int received_index = respFrame[3];
-      ACK_DATA_TC[received_index]=0x01;
-      //ACK_DATA_TC[last_data_packet+3] = respFrame[3];
-      if (((respFrame[3] == 0x13)||( duration > std::chrono::minutes(1)))&& last_data_packet>0){ 
-        time_t currentUnixTime = time(NULL);
-        uint32_t unixTime32 = (uint32_t)currentUnixTime;
-        ACK_DATA_TC[23] = (unixTime32 >> 24) & 0xFF;
-        ACK_DATA_TC[24] = (unixTime32 >> 16) & 0xFF;
-        ACK_DATA_TC[25] = (unixTime32 >> 8) & 0xFF;
-        ACK_DATA_TC[26] = unixTime32 & 0xFF;
-        Log::console(PSTR("Received packets (%u bytes):"), sizeof(ACK_DATA_TC));
-        char *ack_rx_data = new char[buffSize];
-        uint8_t ack_data[sizeof(ACK_DATA_TC)];
-        memcpy(ack_data,ACK_DATA_TC,sizeof(ACK_DATA_TC));
-        for (int i = 0; i < sizeof(ACK_DATA_TC); i++)
-        {
-          sprintf(ack_rx_data + i * 3 % (buffSize - 1), "%02x ", ack_data[i]);
-          if (i * 3 % buffSize == buffSize - 3 || i == sizeof(ACK_DATA_TC)-1)
-            Log::console(PSTR("%s"), ack_rx_data); // print before the buffer is going to loop back
-        }
-        send_data = false;
-        last_data_packet = 0;
-
-        ConfigManager& configManager = ConfigManager::getInstance();
-        uint8_t telecomand_encoded[256];
-        int size = configManager.encode(ACK_DATA_TC,  sizeof(ACK_DATA_TC), telecomand_encoded);
-        sendTx(telecomand_encoded, size);
-        delay(500);
-        sendTx(telecomand_encoded, size);
-        Log::console(PSTR("Sending ACK DATA!"));
+      else
+        Log::console(PSTR("Convolution decoding failed"));
+    }
 
-      }
-      last_data_packet ++;
+    //send_data frames are acknowledged by the download session
+    if (DataSession::getInstance().active()){
+      DataSession::getInstance().onFrame(rxFrame, respLen);
     }
 
     else{
 
-    //read convolution decoded and deinterleaved
-    uint8_t data_deinter[respLen];
-    memcpy(data_deinter,respFrame,respLen);
-    char *rx_str_deinter = new char[buffSize];
-    deinterleave(data_deinter,respLen);
-    //delete padding of interleaved
-    int index = respLen;
-    bool end = false;
-    while(!end){
-      if(data_deinter[index-1]!=0xFF)
-        index--;
-      else{
-        index --;
-        end = true;
-      }
-    }
-    Log::console(PSTR("Packet deinterleaved (%u bytes):"), index);
-    for (int i = 0; i < index; i++)
+    //deinterleaved
+    //a frame that lost its tail is completed up to a whole interleaver block,
+    //the bytes that never arrived are known bad and are handed to RS as erasures
+    const size_t interBlock = interleaverBlock(fec.interleaverDepth);
+    size_t frameLen = (respLen + interBlock - 1) / interBlock * interBlock;
+    if (frameLen > RX_FRAME_SIZE)
+      frameLen = RX_FRAME_SIZE;
+    memset(rxFrame + respLen, 0, frameLen - respLen);
+    uint8_t erasures[RX_FRAME_SIZE];
+    size_t nErasures = 0;
+    if (frameLen > respLen)
+      for (size_t i = 0; i < frameLen; i++)
+        if (deinterleaveSource(i, fec.interleaverDepth) >= respLen)
+          erasures[nErasures++] = i;
+    deinterleave(rxFrame, frameLen, fec.interleaverDepth);
+    size_t index = frameLen;
+    size_t start = 0;
+    if (fec.lengthHeader)
     {
-      sprintf(rx_str_deinter + i * 3 % (buffSize - 1), "%02x ", data_deinter[i]);
-      if (i * 3 % buffSize == buffSize - 3 || i == index - 1)
-        Log::console(PSTR("%s"), rx_str_deinter); // print before the buffer is going to loop back
+      //codeword length from its header, moved down over the header
+      start = LENGTH_HEADER_SIZE;
+      index = readLengthHeader(rxFrame);
+      if (index + start > frameLen)
+      {
+        Log::console(PSTR("Length header (%u) longer than the frame"), index);
+        index = 0;
+      }
+      memmove(rxFrame, rxFrame + start, index);
     }
-    
-    //read convolution decoded, deinterleaved and rs decoded
-    Log::console(PSTR("Packet deinterleaved and rs decoded (%u bytes):"), index);
-    char *rx_str_deinter_ders = new char[buffSize];
-    uint8_t data_deinter_ders[index];
-    memcpy(data_deinter_ders,data_deinter,index);
-    decode_rs(data_deinter_ders,index);
-    for (int i = 0; i < index; i++)
+    else
     {
-      sprintf(rx_str_deinter_ders + i * 3 % (buffSize - 1), "%02x ", data_deinter_ders[i]);
-      if (i * 3 % buffSize == buffSize - 3 || i == index - 1)
-        Log::console(PSTR("%s"), rx_str_deinter_ders); // print before the buffer is going to loop back
+      //delete padding of interleaved
+      bool end = false;
+      while(!end && index > 0){
+        if(rxFrame[index-1]!=0xFF)
+          index--;
+        else{
+          index --;
+          end = true;
+        }
+      }
     }
+    Log::console(PSTR("Packet deinterleaved (%u bytes):"), index);
+    logHex(rxFrame, index);
     
-    //read data packet  
-    Log::console(PSTR("Packet data (%u bytes):"), index - NPAR);
-    char *rx_data = new char[buffSize];
-    uint8_t packet_data[index - NPAR];
-    memcpy(packet_data,data_deinter_ders,index - NPAR);
-    for (int i = 0; i < index - NPAR; i++)
-    {
-      sprintf(rx_data + i * 3 % (buffSize - 1), "%02x ", packet_data[i]);
-      if (i * 3 % buffSize == buffSize - 3 || i == index - NPAR - 1)
-        Log::console(PSTR("%s"), rx_data); // print before the buffer is going to loop back
-    }
+    //rs decoded
+    //erasures that fell in the header or the interleaver padding are not part of the codeword
+    size_t nCodewordErasures = 0;
+    for (size_t i = 0; i < nErasures; i++)
+      if (erasures[i] >= start && erasures[i] - start < index)
+        erasures[nCodewordErasures++] = erasures[i] - start;
+    frame->rs_corrected = decode_rs(rxFrame,index,fec.rsParity,erasures,nCodewordErasures);
     
-    memcpy(respFrame,packet_data,index - NPAR);
-    respLen = index - NPAR;
+    //read data packet, parity is only stripped when there is something to strip
+    respLen = index > fec.rsParity ? index - fec.rsParity : index;
     }
 
     if(send_config){
@@ -494,27 +855,31 @@ uint8_t Radio::listen()
 
       for (uint8_t filter_pos = 0; filter_pos < filter_size; filter_pos++)
       {
-        if (status.modeminfo.filter[2 + filter_pos] != respFrame[filter_ini + filter_pos])
+        if (status.modeminfo.filter[2 + filter_pos] != rxFrame[filter_ini + filter_pos])
           filter_flag = true;
       }
 
       // if the msg start with tiny (test packet) remove filter
-      if (respFrame[0] == 0x54 && respFrame[1] == 0x69 && respFrame[2] == 0x6e && respFrame[3] == 0x79)
+      if (rxFrame[0] == 0x54 && rxFrame[1] == 0x69 && rxFrame[2] == 0x6e && rxFrame[3] == 0x79)
         filter_flag = false;
 
       if (filter_flag)
       {
         Log::console(PSTR("Filter enabled, doesn't look like the expected satellite packet"));
-        delete[] respFrame;
-        startRx();
+        rxPool.release(frame);
         return 5;
       }
     }
 
-    status.lastPacketInfo.crc_error = false;
-    //String encoded = base64::encode(packet_data, index - NPAR);
-    String encoded = base64::encode(respFrame, respLen);
-    MQTT_Client::getInstance().sendRx(encoded, noisyInterrupt);
+    uint32_t cycles = ESP.getCycleCount() - pipelineStart;
+    status.fecStats.rxCycles = cycles;
+    if (cycles > status.fecStats.rxCyclesMax)
+      status.fecStats.rxCyclesMax = cycles;
+    Log::console(PSTR("Packet data (%u bytes, %u cycles):"), respLen, cycles);
+    logHex(rxFrame, respLen);
+
+    frame->length = respLen;
+    queueReport(frame);
   }
   else if (state == ERR_CRC_MISMATCH)
   {
@@ -522,56 +887,18 @@ uint8_t Radio::listen()
     if (status.modeminfo.filter[0] == 0)
     {
       // packet was received, but is malformed
-      status.lastPacketInfo.crc_error = true;
-      String error_encoded = base64::encode("Error_CRC");
-      MQTT_Client::getInstance().sendRx(error_encoded, noisyInterrupt);
+      frame->crc_error = true;
+      queueReport(frame);
     }
     else
     {
       Log::console(PSTR("Filter enabled, Error CRC filtered"));
-      delete[] respFrame;
-      startRx();
+      rxPool.release(frame);
       return 5;
     }
   }
-
-  delete[] respFrame;
-
-  struct tm *timeinfo;
-  time_t currenttime = time(NULL);
-  if (currenttime < 0)
-  {
-    Log::error(PSTR("Failed to obtain time"));
-    status.lastPacketInfo.time = "";
-  }
   else
-  {
-    // store time of the last packet received:
-    timeinfo = localtime(&currenttime);
-    String thisTime = "";
-    if (timeinfo->tm_hour < 10)
-    {
-      thisTime = thisTime + " ";
-    } // add leading space if required
-    thisTime = String(timeinfo->tm_hour) + ":";
-    if (timeinfo->tm_min < 10)
-    {
-      thisTime = thisTime + "0";
-    } // add leading zero if required
-    thisTime = thisTime + String(timeinfo->tm_min) + ":";
-    if (timeinfo->tm_sec < 10)
-    {
-      thisTime = thisTime + "0";
-    } // add leading zero if required
-    thisTime = thisTime + String(timeinfo->tm_sec);
-
-    status.lastPacketInfo.time = thisTime;
-  }
-
-  noisyInterrupt = false;
-
-  // put module back to listen mode
-  startRx();
+    rxPool.release(frame);
 
   if (state == ERR_NONE)
   {
@@ -581,51 +908,18 @@ uint8_t Radio::listen()
   {
     // packet was received, but is malformed
     Log::console(PSTR("[SX12x8] CRC error! Data cannot be retrieved"));
-    int16_t buffSize = respLen * 3 + 1;
 
     if(send_config){
 
-      Log::console(PSTR("Config not received, send NACK packet (%u bytes):"), sizeof(NACK_CONFIG_TC));
-      char *nack_rx_data = new char[buffSize];
-      uint8_t nack_data[sizeof(NACK_CONFIG_TC)];
-      memcpy(nack_data,NACK_CONFIG_TC,sizeof(NACK_CONFIG_TC));
-      for (int i = 0; i < sizeof(NACK_CONFIG_TC); i++)
-      {
-        sprintf(nack_rx_data + i * 3 % (buffSize - 1), "%02x ", nack_data[i]);
-        if (i * 3 % buffSize == buffSize - 3 || i == sizeof(NACK_CONFIG_TC)-1)
-          Log::console(PSTR("%s"), nack_rx_data); // print before the buffer is going to loop back
-      }
-
-      ConfigManager& configManager = ConfigManager::getInstance();
-      uint8_t telecomand_encoded[256];
-      int size = configManager.encode(NACK_CONFIG_TC,  sizeof(NACK_CONFIG_TC), telecomand_encoded);
-      sendTx(telecomand_encoded, size);
-      delay(500);
-      sendTx(telecomand_encoded, size);
-      Log::console(PSTR("Sending NACK CONFIG!"));
+      Log::console(PSTR("Config not received"));
+      Telecommands::getInstance().send(TC_NACK_CONFIG);
       send_config=false;
 
     }
     if(send_telemetry){
 
-      Log::console(PSTR("Telemetry not received, send NACK packet (%u bytes):"), sizeof(NACK_TELEMETRY_TC));
-      char *nack_rx_data = new char[buffSize];
-      uint8_t nack_data[sizeof(NACK_TELEMETRY_TC)];
-      memcpy(nack_data,NACK_TELEMETRY_TC,sizeof(NACK_TELEMETRY_TC));
-      for (int i = 0; i < sizeof(NACK_TELEMETRY_TC); i++)
-      {
-        sprintf(nack_rx_data + i * 3 % (buffSize - 1), "%02x ", nack_data[i]);
-        if (i * 3 % buffSize == buffSize - 3 || i == sizeof(NACK_TELEMETRY_TC)-1)
-          Log::console(PSTR("%s"), nack_rx_data); // print before the buffer is going to loop back
-      }
-
-      ConfigManager& configManager = ConfigManager::getInstance();
-      uint8_t telecomand_encoded[256];
-      int size = configManager.encode(NACK_TELEMETRY_TC,  sizeof(NACK_TELEMETRY_TC), telecomand_encoded);
-      sendTx(telecomand_encoded, size);
-      delay(500);
-      sendTx(telecomand_encoded, size);
-      Log::console(PSTR("Sending NACK TELEMETRY!"));
+      Log::console(PSTR("Telemetry not received"));
+      Telecommands::getInstance().send(TC_NACK_TELEMETRY);
       send_telemetry=false;
 
     }
@@ -661,6 +955,7 @@ void Radio::readState(int state)
 // remote
 int16_t Radio::remote_freq(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   float frequency = _atof(payload, payload_len);
   Log::console(PSTR("Set Frequency: %.3f MHz"), frequency);
 
@@ -681,12 +976,14 @@ int16_t Radio::remote_freq(char *payload, size_t payload_len)
   readState(state);
   if (state == ERR_NONE)
     status.modeminfo.frequency = frequency;
+  Doppler::getInstance().reset();
 
   return state;
 }
 
 int16_t Radio::remote_bw(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   float bw = _atof(payload, payload_len);
   Log::console(PSTR("Set bandwidth: %.3f MHz"), bw);
 
@@ -713,6 +1010,7 @@ int16_t Radio::remote_bw(char *payload, size_t payload_len)
 
 int16_t Radio::remote_sf(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   uint8_t sf = _atof(payload, payload_len);
   Log::console(PSTR("Set spreading factor: %u"), sf);
 
@@ -740,6 +1038,7 @@ int16_t Radio::remote_sf(char *payload, size_t payload_len)
 
 int16_t Radio::remote_cr(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   uint8_t cr = _atoi(payload, payload_len);
   Log::console(PSTR("Set coding rate: %u"), cr);
 
@@ -767,6 +1066,7 @@ int16_t Radio::remote_cr(char *payload, size_t payload_len)
 
 int16_t Radio::remote_crc(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   bool crc = _atoi(payload, payload_len);
   Log::console(PSTR("Set CRC: %s"), crc ? F("ON") : F("OFF"));
   int16_t state = 0;
@@ -790,6 +1090,7 @@ int16_t Radio::remote_crc(char *payload, size_t payload_len)
 
 int16_t Radio::remote_lsw(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   uint8_t sw = _atoi(payload, payload_len);
   char strHex[2];
   sprintf(strHex, "%1x", sw);
@@ -807,6 +1108,7 @@ int16_t Radio::remote_lsw(char *payload, size_t payload_len)
 
 int16_t Radio::remote_fldro(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   bool ldro = _atoi(payload, payload_len);
   Log::console(PSTR("Set ForceLDRO: %s"), ldro ? F("ON") : F("OFF"));
 
@@ -839,6 +1141,7 @@ int16_t Radio::remote_fldro(char *payload, size_t payload_len)
 
 int16_t Radio::remote_aldro(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   Log::console(PSTR("Set AutoLDRO "));
   int16_t state = 0;
 
@@ -861,6 +1164,7 @@ int16_t Radio::remote_aldro(char *payload, size_t payload_len)
 
 int16_t Radio::remote_pl(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   uint16_t pl = _atoi(payload, payload_len);
   Log::console(PSTR("Set Preamble %u"), pl);
   int16_t state = 0;
@@ -887,6 +1191,7 @@ int16_t Radio::remote_pl(char *payload, size_t payload_len)
 
 int16_t Radio::remote_begin_lora(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   DynamicJsonDocument doc(256);
   deserializeJson(doc, payload, payload_len);
   float freq = doc[0];
@@ -939,6 +1244,7 @@ int16_t Radio::remote_begin_lora(char *payload, size_t payload_len)
 
 int16_t Radio::remote_begin_fsk(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   DynamicJsonDocument doc(256);
   deserializeJson(doc, payload, payload_len);
   float freq = doc[0];
@@ -987,6 +1293,7 @@ int16_t Radio::remote_begin_fsk(char *payload, size_t payload_len)
 
 int16_t Radio::remote_br(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   uint8_t br = _atoi(payload, payload_len);
   Log::console(PSTR("Set FSK Bit rate: %u"), br);
 
@@ -1005,6 +1312,7 @@ int16_t Radio::remote_br(char *payload, size_t payload_len)
 
 int16_t Radio::remote_fd(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   uint8_t fd = _atoi(payload, payload_len);
   Log::console(PSTR("Set FSK Frequency Dev.: %u"), fd);
 
@@ -1023,6 +1331,7 @@ int16_t Radio::remote_fd(char *payload, size_t payload_len)
 
 int16_t Radio::remote_fbw(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   float frequency = _atof(payload, payload_len);
   Log::console(PSTR("Set FSK bandwidth: %.3f kHz"), frequency);
 
@@ -1041,6 +1350,7 @@ int16_t Radio::remote_fbw(char *payload, size_t payload_len)
 
 int16_t Radio::remote_fsw(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   DynamicJsonDocument doc(256);
   deserializeJson(doc, payload, payload_len);
   uint8_t synnwordsize = doc.size();
@@ -1071,6 +1381,7 @@ int16_t Radio::remote_fsw(char *payload, size_t payload_len)
 
 int16_t Radio::remote_fook(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   DynamicJsonDocument doc(60);
   deserializeJson(doc, payload, payload_len);
   bool enableOOK = doc[0];
@@ -1101,6 +1412,7 @@ int16_t Radio::remote_fook(char *payload, size_t payload_len)
 
 void Radio::remote_SPIwriteRegister(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   DynamicJsonDocument doc(60);
   deserializeJson(doc, payload, payload_len);
   uint8_t reg = doc[0];
@@ -1115,6 +1427,7 @@ void Radio::remote_SPIwriteRegister(char *payload, size_t payload_len)
 
 int16_t Radio::remote_SPIreadRegister(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   uint8_t reg = _atoi(payload, payload_len);
   uint8_t data = 0;
 
@@ -1132,6 +1445,7 @@ int16_t Radio::remote_SPIreadRegister(char *payload, size_t payload_len)
 
 int16_t Radio::remote_SPIsetRegValue(char *payload, size_t payload_len)
 {
+  RadioLock lock;
   DynamicJsonDocument doc(120);
   deserializeJson(doc, payload, payload_len);
   uint8_t reg = doc[0];
@@ -1181,76 +1495,190 @@ int Radio::_atoi(const char *buff, size_t length)
   return atoi(str);
 }
 
-void  Radio::decode_conv(uint8_t* data, size_t length)
+// Prints data as hex, 84 bytes per console line
+void Radio::logHex(const uint8_t* data, size_t length)
 {
-  correct_convolutional *conv = correct_convolutional_create(RATE_CON, ORDER_CON, correct_conv_r12_7_polynomial);
-  int index = ceil(length/RATE_CON);
-  uint8_t conv_decoded[index];
-  ssize_t decoded_conv_size = correct_convolutional_decode(conv, data, length*8, conv_decoded);
-  memcpy(data, conv_decoded,decoded_conv_size);
+  char line[LOG_HEX_BYTES * 3 + 1];
+  size_t pos = 0;
+  for (size_t i = 0; i < length; i++)
+  {
+    sprintf(line + pos, "%02x ", data[i]);
+    pos += 3;
+    if (pos == sizeof(line) - 1 || i == length - 1)
+    {
+      Log::console(PSTR("%s"), line);
+      pos = 0;
+    }
+  }
 }
 
-void  Radio::deinterleave(uint8_t* data, size_t length)
+// Soft-decision Viterbi over codedBits coded bits. Each received bit becomes a
+// soft symbol pushed from the erased value (128) towards 0 or 255 by the
+// confidence of its byte, 0..127 (nullptr = every received byte at 127).
+// Bits past length never arrived and stay erased. At most outSize decoded bytes
+// are copied to out, which may be data itself
+ssize_t Radio::decode_conv_soft(const uint8_t* data, size_t length, size_t codedBits, const uint8_t* confidence, uint8_t* out, size_t outSize)
 {
-  bool end = false;
-	int q = 0;
-	int r = 0;
-	int col;
-	int row;
-	uint8_t block[BLOCK_ROW_INTER][BLOCK_COL_INTER];
-  uint8_t codeword_deinterleaved[length];
-
-	while(q < length){
-		for(col=0; col < BLOCK_COL_INTER && !end; col++){
-			for(row=0; row < BLOCK_ROW_INTER && !end; row++){
-				if (q < length){
-					block[row][col] = data[q];
-					q++;
-				}
-				else{
-					end = true;
-				}
-			}
-		}
-		for(int t = 0; t < BLOCK_COL_INTER; t++){
-			for(int p = 0; p < BLOCK_ROW_INTER; p++){
-					codeword_deinterleaved[r] = block[t][p];
-					r++;
-			}
-		}
-	}
-  memcpy(data,codeword_deinterleaved,length);
+  // a whole frame of coded bits plus the flush bits, static so the 4 KB of
+  // soft symbols stay off the FEC task stack. The decoder writes one byte more
+  // than the frame holds, so it decodes into its own buffer
+  static const size_t MAX_CODED_BITS = (RX_FRAME_SIZE * 8 + ORDER_CON + 1) * RATE_CON;
+  static uint8_t soft[MAX_CODED_BITS];
+  static uint8_t decoded[MAX_CODED_BITS / RATE_CON / 8 + 1];
+
+  if (!codecs.ready || codedBits > MAX_CODED_BITS)
+    return -1;
+
+  for (size_t i = 0; i < codedBits; i++)
+  {
+    size_t byte = i / 8;
+    if (byte >= length)
+    {
+      soft[i] = 128;
+      continue;
+    }
+    uint8_t conf = confidence ? (confidence[byte] & 0x7F) : 127;
+    soft[i] = (data[byte] >> (7 - i % 8)) & 1 ? 128 + conf : 127 - conf;
+  }
+
+  ssize_t decodedLen = correct_convolutional_decode_soft(codecs.conv, soft, codedBits, decoded);
+  if (decodedLen <= 0)
+    return decodedLen;
+  if ((size_t)decodedLen > outSize)
+    decodedLen = outSize;
+  memcpy(out, decoded, decodedLen);
+  return decodedLen;
 }
 
-void  Radio::decode_rs(uint8_t* data, size_t length)
+typedef BlockInterleaver<4, 4> Interleaver4;
+typedef BlockInterleaver<8, 8> Interleaver8;
+typedef BlockInterleaver<16, 16> Interleaver16;
+
+// Bitwise majority of the three copies of the length header, any one copy
+// can be lost or corrupted without changing the result
+uint8_t Radio::readLengthHeader(const uint8_t* frame)
 {
-  
-  
-  correct_reed_solomon *rs = correct_reed_solomon_create(correct_rs_primitive_polynomial_ccsds, 1, 1, MIN_DISTANCE_RS);
-  uint8_t rs_decoded[MESSAGE_LENGTH_RS];  
-  ssize_t size_decode = correct_reed_solomon_decode(rs, data, length, rs_decoded); 
+  return (frame[0] & frame[1]) | (frame[0] & frame[2]) | (frame[1] & frame[2]);
+}
 
-  
-  initialize_ecc();
-  srand(time(NULL));
-  unsigned char *data_ch[length];
-  memcpy(data_ch,data,length);
-  decode_data(data, length);
-  
-  int erasures[16];
-  int nerasures = 0;
-  int syndrome = check_syndrome();
-  
-  // check if syndrome is all zeros 
+// Bytes per interleaver block with the depth selected by the modem config
+size_t Radio::interleaverBlock()
+{
+  return interleaverBlock(status.modeminfo.interleaverDepth);
+}
+
+size_t Radio::interleaverBlock(uint8_t depth)
+{
+  switch (depth)
+  {
+    case 8: return Interleaver8::BLOCK;
+    case 16: return Interleaver16::BLOCK;
+    default: return Interleaver4::BLOCK;
+  }
+}
+
+// Index in the interleaved frame of the byte that ends up at position i once
+// deinterleaved, each interleaver block is permuted on its own
+size_t Radio::deinterleaveSource(size_t i)
+{
+  return deinterleaveSource(i, status.modeminfo.interleaverDepth);
+}
 
-  if (syndrome == 0) {
-    // no errs detected, codeword payload should match message
+size_t Radio::deinterleaveSource(size_t i, uint8_t depth)
+{
+  size_t block = interleaverBlock(depth);
+  size_t j = i % block;
+  switch (depth)
+  {
+    case 8: return i - j + Interleaver8::deinterleaveTable[j];
+    case 16: return i - j + Interleaver16::deinterleaveTable[j];
+    default: return i - j + Interleaver4::deinterleaveTable[j];
+  }
+}
+
+// Both directions work in place, length must be a whole number of interleaver blocks
+void  Radio::deinterleave(uint8_t* data, size_t length, uint8_t depth)
+{
+  switch (depth)
+  {
+    case 8: Interleaver8::deinterleave(data, length); break;
+    case 16: Interleaver16::deinterleave(data, length); break;
+    default: Interleaver4::deinterleave(data, length); break;
+  }
+}
+
+void  Radio::interleave(uint8_t* data, size_t length)
+{
+  switch (status.modeminfo.interleaverDepth)
+  {
+    case 8: Interleaver8::interleave(data, length); break;
+    case 16: Interleaver16::interleave(data, length); break;
+    default: Interleaver4::interleave(data, length); break;
+  }
+}
+
+// Decodes in place with the RS code selected by the modem config, the message
+// is left at the start of data. Returns the corrected symbols or -1 on failure.
+// parity is what the frame layout was taken with, a code rebuilt since then
+// is not used. erasures are positions in data known to be bad (lost or
+// flagged by the demodulator), the code corrects twice as many of those as
+// unknown errors
+int  Radio::decode_rs(uint8_t* data, size_t length, uint8_t parity, const uint8_t* erasures, size_t nErasures)
+{
+  if (!parity)
+    return 0;
+
+  if (length <= parity)
+    return -1;
+
+  if (nErasures > parity)
+  {
+    Log::console(PSTR("Too many erasures (%u), decoding without them"), nErasures);
+    nErasures = 0;
+  }
+  else if (nErasures)
+    Log::console(PSTR("Decoding with %u erasures"), nErasures);
+
+  // only the decode itself runs under the FEC mutex, begin() waits for it
+  ssize_t size_decode = -1;
+  int corrected = 0;
+  xSemaphoreTake(fecMutex, portMAX_DELAY);
+  bool current = codecs.rsParity == parity;
+  bool built = codecs.rs != nullptr;
+  if (current && built)
+  {
+    size_decode = nErasures ?
+      correct_reed_solomon_decode_with_erasures(codecs.rs, data, length, erasures, nErasures, data) :
+      correct_reed_solomon_decode(codecs.rs, data, length, data);
+    if (size_decode >= 0)
+      corrected = correct_reed_solomon_corrected(codecs.rs);
+  }
+  xSemaphoreGive(fecMutex);
+
+  if (!current)
+  {
+    Log::console(PSTR("Reed-Solomon code changed while decoding, frame not corrected"));
+    return -1;
+  }
+  if (!built)
+    return -1;
+  if (size_decode < 0)
+  {
+    status.fecStats.rsFailed++;
+    Log::console(PSTR("Errors detected, unable to correct them"));
+    return -1;
+  }
+
+  if (corrected)
+  {
+    status.fecStats.rsCorrected++;
+    Log::console(PSTR("Errors detected, %d symbols corrected"), corrected);
+  }
+  else
+  {
+    status.fecStats.rsClean++;
     Log::console(PSTR("No errors detected, codeword payload should match message"));
-  } else {
-    //nonzero syndrome, attempting correcting errors
-    int result = 0;//result 0 not able to correct, result 1 corrected
-    Log::console(PSTR("Errors detected, proceeding to correct errors"));
-    result =correct_errors_erasures (data,length,nerasures,erasures);
   }
-  
+
+  return corrected;
 }
@@ -28,11 +28,14 @@
 #include "../ConfigManager/ConfigManager.h"
 #include "../Status.h"
 #include "../Mqtt/MQTT_Client.h"
+#include "correct/reed-solomon.h"
+#include "correct/convolutional.h"
+#include "FrameRing.h"
+#include "FramePool.h"
 
 #ifndef GLOBALS_H
 #define GLOBALS_H
 
-extern bool send_data;
 extern bool send_config;
 extern bool send_telemetry;
 extern Status status;
@@ -40,6 +43,38 @@ extern Status status;
 #endif // GLOBALS_H
 
 
+// FEC contexts shared by the RX decoder and the TC encoder, built once at init
+struct FecCodecs {
+  correct_reed_solomon* rs = nullptr;   // the one RS code selected by the modem config
+  bool rsCcsds = false;
+  uint8_t rsParity = 0;
+  correct_convolutional* conv = nullptr;
+  bool ready = false;
+  uint32_t buildTime = 0; // us
+  uint32_t heapUsed = 0;  // bytes
+  // received frame layout, copied from the modem config by begin()
+  bool convolutional = false;
+  uint8_t interleaverDepth = 0;
+  bool lengthHeader = false;
+};
+
+// The layout one received frame is decoded with, taken once per frame
+struct FecLayout {
+  bool conv;
+  uint8_t interleaverDepth;
+  bool lengthHeader;
+  uint8_t rsParity;
+};
+
+// A frame waiting in the TX queue, sent copies times with spacing us of
+// listening before each transmission
+struct TxFrame {
+  uint8_t data[255];
+  uint8_t length;
+  uint8_t copies;
+  uint32_t spacing;
+};
+
 class Radio {
 public:
   static Radio& getInstance()
@@ -49,12 +84,19 @@ public:
   }
 
   void init();
+  void initCodecs();
+  const FecCodecs& getCodecs() { return codecs; }
   int16_t begin();
   void enableInterrupt();
   void disableInterrupt();
   void startRx();
   uint8_t listen();
+  RxFrame* takeFrame();
+  void releaseFrame(RxFrame* frame);
   bool isReady() { return status.radio_ready; }
+  bool sleep();
+  bool retune(double frequency);
+  bool isSleeping() { return sleeping; }
   int16_t remote_freq(char* payload, size_t payload_len);
   int16_t remote_bw(char* payload, size_t payload_len);
   int16_t remote_sf(char* payload, size_t payload_len);
@@ -74,50 +116,74 @@ public:
   int16_t remote_SPIsetRegValue(char* payload, size_t payload_len);
   void remote_SPIwriteRegister(char* payload, size_t payload_len);
   int16_t remote_SPIreadRegister(char* payload, size_t payload_len);
-  int16_t sendTx(uint8_t* data, size_t length);
+  int16_t sendTx(const uint8_t* data, size_t length, uint8_t copies = 1, uint32_t spacing = 0);
   int16_t sendTestPacket();
-  void decode_conv(uint8_t* data, size_t length);
-  void deinterleave(uint8_t* data, size_t length);
-  void decode_rs(uint8_t* data, size_t length);
-  byte RESET_TC[3] = {0xC8, 0x9D, 0x01};
-  byte EXIT_STATE_TC[5] = {0xC8, 0x9D, 0x02, 0x00, 0x00};
-  byte TLE_TC_1[37] = {0xC8, 0x9D, 0x0A,  0x31, 0x20, 0x34, 0x31, 0x37, 0x33, 0x32, 0x55, 0x20, 0x31, 0x36, 0x30,   
-                    0x35, 0x31, 0x42, 0x20, 0x31, 0x36, 0x32, 0x36, 0x36, 0x2e, 0x33, 0x30, 0x31, 0x39, 0x39, 0x31, 0x34, 0x34,  
-                    0x20, 0x2e, 0x30, 0x30};
-  byte TLE_TC1[37] = {0xC8, 0x9D, 0x0A, 0x31, 0x20, 0x34, 0x30, 0x30, 0x34, 0x30, 0x55, 0x20, 0x31, 0x34, 0x30, 0x33, 0x33, 0x41, 0x47, 0x20, 0x20, 0x32, 0x32,
-                    0x33, 0x34, 0x30, 0x2e, 0x37, 0x31, 0x34, 0x34, 0x35, 0x31, 0x36, 0x32, 0x20, 0x2e};
-  byte TLE_TC_2[37] = {0xC8, 0x9D, 0x0A, 0x30, 0x30, 0x30, 0x30, 0x36, 0x38, 0x33, 0x39, 0x20, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x30, 0x20, 0x20, 0x35, 0x38, 0x37,
-                    0x31, 0x30, 0x2d, 0x33, 0x20, 0x30, 0x20, 0x39, 0x39, 0x39, 0x30, 0x0a, 0x32, 0x20};
-  byte TLE_TC_3[37] = {0xC8, 0x9D, 0x0A, 0x34, 0x30, 0x30, 0x34, 0x30, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x30,
-                    0x20, 0x31, 0x34, 0x2e, 0x39, 0x37, 0x37, 0x36, 0x33, 0x36, 0x32, 0x34, 0x30, 0x20};
-  byte TLE_TC_4[37] = {0xC8, 0x9D, 0x0A, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x30, 0x20, 0x31, 0x38, 0x30, 0x30, 0x20, 0x32, 0x30, 0x37, 0x2e, 0x31, 0x32,
-                    0x33, 0x33, 0x33, 0x20, 0x32, 0x30, 0x37, 0x2e, 0x33, 0x33, 0x35, 0x36, 0x20, 0x31};
-  byte TLE_TC_5[5] = {0xC8, 0x9D, 0x0A, 0x34, 0x30};
-  byte ADCS_CALIBRATION_TC_1[37] = {0xC8, 0x9D, 0x0B, 0x0, 0xC8, 0x9D, 0x0A, 0x31, 0x20, 0x34, 0x31, 0x37, 0x33, 0x32, 0x55, 0x20, 0x31, 0x36, 0x30,  
-                    0x35, 0x31, 0x42, 0x20, 0x31, 0x36, 0x32, 0x36, 0x36, 0x2e, 0x33, 0x30, 0x31, 0x39, 0x39, 0x31, 0x34, 0x34};
-  byte ADCS_CALIBRATION_TC_2[37] ={ 0xC8, 0x9D, 0x0B, 0x1, 0x20, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x32, 0x35, 0x33, 0x31, 0x20, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x30,
-                    0x20, 0x31, 0x30, 0x37, 0x39, 0x35, 0x2d, 0x33, 0x20, 0x30, 0x20, 0x39, 0x39, 0x39, 0x38};   
-  byte ADCS_CALIBRATION_TC_3[37] = { 0xC8, 0x9D, 0x0B, 0x2,0x0a, 0x32, 0x20, 0xC8, 0x9D, 0x0A, 0x34, 0x31, 0x37, 0x33, 0x32, 0x20, 0x39, 0x37, 0x2e, 0x33, 0x37, 0x33, 0x34, 0x20, 0x31, 0x38, 0x31, 0x2e,
-                      0x34, 0x35, 0x32, 0x30, 0x20, 0x30, 0x0, 0x0, 0x0};   
-  byte SEND_DATA_TC[4] = {0xC8, 0x9D, 0x14, 0x00};
-  byte SEND_TELEMETRY_TC[3] = {0xC8, 0x9D, 0x15};
-  byte STOP_SENDING_DATA_TC[3] = {0xC8, 0x9D, 0x16};
-  byte CHANGE_TIMEOUT_TC[5] = {0xC8, 0x9D, 0x17, 0x00, 0xC8};
-  byte ACTIVATE_PAYLOAD_TC[33] = {0xC8, 0x9D, 0x1E, 0x2e, 0x30, 0x30, 0x30, 0x30, 0x32, 0x35, 0x33, 0x31, 0x20, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x30,
-                    0x20, 0x31, 0x30, 0x37, 0x39, 0x35, 0x2d, 0x33, 0x20, 0x30, 0x20, 0x39, 0x39};
-  byte SEND_CONFIG_TC[3] = {0xC8, 0x9D, 0x28};
-  byte UPLINK_CONFIG_TC[21] = {0xC8, 0x9D, 0x29, 0x30, 0x30, 0x30, 0x32, 0x35, 0x33, 0x31, 0x20, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2d, 0x30,
-                    0x20, 0x31, 0x30};
-  byte NACK_TELEMETRY_TC[3] = {0xC8, 0x9D, 0x19};
-  byte NACK_CONFIG_TC[3] = {0xC8, 0x9D, 0x1A};
-  byte ACK_DATA_TC[27];
+  ssize_t decode_conv_soft(const uint8_t* data, size_t length, size_t codedBits, const uint8_t* confidence, uint8_t* out, size_t outSize);
+  static void deinterleave(uint8_t* data, size_t length, uint8_t depth);
+  void interleave(uint8_t* data, size_t length);
+  size_t deinterleaveSource(size_t i);
+  static size_t deinterleaveSource(size_t i, uint8_t depth);
+  size_t interleaverBlock();
+  static size_t interleaverBlock(uint8_t depth);
+  static uint8_t readLengthHeader(const uint8_t* frame);
+  static const size_t LENGTH_HEADER_SIZE = 3; // copies of the codeword length ahead of the codeword
+  // the longest packet both chips take, RadioLib refuses SX127X_MAX_PACKET_LENGTH on the SX127x
+  static const size_t TX_PACKET_SIZE = SX127X_MAX_PACKET_LENGTH - 1;
+  int decode_rs(uint8_t* data, size_t length, uint8_t parity, const uint8_t* erasures = nullptr, size_t nErasures = 0);
   
 private:
+  friend class RadioLock;
   Radio();
   PhysicalLayer* lora;
   void readState(int state);
   static void setFlag();
+  static void rxTask(void* param);
+  static void fecTask(void* param);
+  void readFrame();
+  void serviceTx();
+  void finishTx();
+  void setCarrier(double frequency);
+  void restoreCarrier();
+  TickType_t txWait();
+  void queueReport(RxFrame* frame);
+  void startReceive();
+  void lock();
+  void unlock();
+  SemaphoreHandle_t radioMutex;
+  SemaphoreHandle_t fecMutex;  // the RS code, its workspace and the frame layout in codecs
+  bool sleeping = false;
+  bool txCorrected = false;  // the carrier was moved for the uplink Doppler
+  void configureFec();
+  void configureRs();
+  FecLayout fecLayout();
+  static void logHex(const uint8_t* data, size_t length);
+  static const size_t RX_FRAME_SIZE = sizeof(RxFrame::data);
+  static const size_t LOG_HEX_BYTES = 84;
+  static const size_t RX_POOL_FRAMES = 6;
+  static const size_t RX_RING_SLOTS = 8;        // one per pooled frame, so pushing never fails
+  static const size_t TX_POOL_FRAMES = 8;       // a whole TLE upload plus a couple of replies
+  static const size_t TX_RING_SLOTS = 8;
+  static const int64_t TX_TIMEOUT = 15000000;    // us, longer than any frame at SF12
+  static const BaseType_t RADIO_CORE = 1;        // APP_CPU, the network task, WiFi and lwIP live on core 0
+  static const uint32_t RX_TASK_STACK = 4096;
+  static const UBaseType_t RX_TASK_PRIORITY = 5; // above the FEC task, below WiFi and lwIP
+  static const uint32_t FEC_TASK_STACK = 12288;  // viterbi soft symbols and RS decoding live on it
+  static const UBaseType_t FEC_TASK_PRIORITY = 4;
+  static const size_t REPORT_QUEUE_DEPTH = RX_POOL_FRAMES;
+  QueueHandle_t reportQueue = nullptr;  // decoded frames waiting for the main loop
+  float lastRssi = 0;
+  float lastSnr = 0;
+  float lastFrequencyError = 0;
+  FramePool<RxFrame, RX_POOL_FRAMES> rxPool;    // every received frame lives in one of these
+  FrameRing<RxFrame*, RX_RING_SLOTS> rxRing;    // frames read by the RX task, waiting for listen()
+  FramePool<TxFrame, TX_POOL_FRAMES> txPool;
+  FrameRing<TxFrame*, TX_RING_SLOTS> txRing;    // pushed with the radio locked, the RX task sends them
+  TxFrame* txFrame = nullptr;                   // on air or waiting for its slot
+  uint8_t txCopiesSent = 0;
+  int64_t txStarted = 0;                        // esp_timer_get_time() of the current transmission
+  int64_t txEnded = 0;                          // and of the end of the last one
   SPIClass spi;
+  FecCodecs codecs;
   const char* TEST_STRING = "TinyGS-test "; // make sure this always start with "TinyGS-test"!!!
 
   double _atof(const char* buff, size_t length);
@@ -125,5 +191,16 @@ private:
 
 };
 
+// Holds the radio (SPI bus and chip state) for its scope, the RX task and the
+// main loop both drive it. Recursive, so locked methods can call each other.
+// Lock order: RadioLock is taken last. DataSession never holds its mutex while
+// calling into the radio, and the FEC task decodes without the radio, under
+// the FEC mutex alone, which begin() takes with the radio held
+class RadioLock {
+public:
+  RadioLock() { Radio::getInstance().lock(); }
+  ~RadioLock() { Radio::getInstance().unlock(); }
+};
+
 
 #endif
\ No newline at end of file
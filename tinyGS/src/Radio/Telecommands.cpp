@@ -0,0 +1,321 @@
+/*
+  Telecommands.cpp - Table of the telecommands the station can uplink, pre-encoded once
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#include "Telecommands.h"
+#include "Radio.h"
+#include "DataSession.h"
+#include "../Orbit/Orbit.h"
+#include "../Logger/Logger.h"
+
+const uint8_t Telecommands::HEADER[2] = {0xC8, 0x9D};
+
+static const uint8_t EXIT_STATE[] = {0x00, 0x00};
+static const uint8_t TLE_1[] = {0x31, 0x20, 0x34, 0x31, 0x37, 0x33, 0x32, 0x55, 0x20, 0x31, 0x36, 0x30, 0x35, 0x31, 0x42, 0x20, 0x31,
+                                0x36, 0x32, 0x36, 0x36, 0x2E, 0x33, 0x30, 0x31, 0x39, 0x39, 0x31, 0x34, 0x34, 0x20, 0x2E, 0x30, 0x30};
+static const uint8_t TLE_2[] = {0x30, 0x30, 0x30, 0x30, 0x36, 0x38, 0x33, 0x39, 0x20, 0x30, 0x30, 0x30, 0x30, 0x2D, 0x30, 0x20, 0x20,
+                                0x35, 0x38, 0x37, 0x31, 0x30, 0x2D, 0x33, 0x20, 0x30, 0x20, 0x39, 0x39, 0x39, 0x30, 0x0A, 0x32, 0x20};
+static const uint8_t TLE_3[] = {0x34, 0x30, 0x30, 0x34, 0x30, 0x20, 0x20, 0x20, 0x20, 0x20, 0x30, 0x2E, 0x30, 0x30, 0x30, 0x30, 0x30,
+                                0x30, 0x2D, 0x30, 0x20, 0x31, 0x34, 0x2E, 0x39, 0x37, 0x37, 0x36, 0x33, 0x36, 0x32, 0x34, 0x30, 0x20};
+static const uint8_t TLE_4[] = {0x2E, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2D, 0x30, 0x20, 0x31, 0x38, 0x30, 0x30, 0x20, 0x32, 0x30, 0x37,
+                                0x2E, 0x31, 0x32, 0x33, 0x33, 0x33, 0x20, 0x32, 0x30, 0x37, 0x2E, 0x33, 0x33, 0x35, 0x36, 0x20, 0x31};
+static const uint8_t TLE_5[] = {0x34, 0x30};
+static const uint8_t ADCS_CALIBRATION_1[] = {0x00, 0xC8, 0x9D, 0x0A, 0x31, 0x20, 0x34, 0x31, 0x37, 0x33, 0x32, 0x55, 0x20, 0x31, 0x36, 0x30, 0x35,
+                                             0x31, 0x42, 0x20, 0x31, 0x36, 0x32, 0x36, 0x36, 0x2E, 0x33, 0x30, 0x31, 0x39, 0x39, 0x31, 0x34, 0x34};
+static const uint8_t ADCS_CALIBRATION_2[] = {0x01, 0x20, 0x2E, 0x30, 0x30, 0x30, 0x30, 0x32, 0x35, 0x33, 0x31, 0x20, 0x30, 0x30, 0x30, 0x30, 0x30,
+                                             0x2D, 0x30, 0x20, 0x31, 0x30, 0x37, 0x39, 0x35, 0x2D, 0x33, 0x20, 0x30, 0x20, 0x39, 0x39, 0x39, 0x38};
+static const uint8_t ADCS_CALIBRATION_3[] = {0x02, 0x0A, 0x32, 0x20, 0xC8, 0x9D, 0x0A, 0x34, 0x31, 0x37, 0x33, 0x32, 0x20, 0x39, 0x37, 0x2E, 0x33,
+                                             0x37, 0x33, 0x34, 0x20, 0x31, 0x38, 0x31, 0x2E, 0x34, 0x35, 0x32, 0x30, 0x20, 0x30, 0x00, 0x00, 0x00};
+static const uint8_t SEND_DATA[] = {0x00};
+static const uint8_t CHANGE_TIMEOUT[] = {0x00, 0xC8};
+static const uint8_t ACTIVATE_PAYLOAD[] = {0x2E, 0x30, 0x30, 0x30, 0x30, 0x32, 0x35, 0x33, 0x31, 0x20, 0x30, 0x30, 0x30, 0x30, 0x30,
+                                           0x2D, 0x30, 0x20, 0x31, 0x30, 0x37, 0x39, 0x35, 0x2D, 0x33, 0x20, 0x30, 0x20, 0x39, 0x39};
+static const uint8_t UPLINK_CONFIG[] = {0x30, 0x30, 0x30, 0x32, 0x35, 0x33, 0x31, 0x20, 0x30, 0x30, 0x30, 0x30, 0x30, 0x2D, 0x30, 0x20, 0x31, 0x30};
+
+#define TC_PART(p) {p, sizeof(p)}
+static const TcPart NO_PAYLOAD[] = {{nullptr, 0}};
+static const TcPart EXIT_STATE_PARTS[] = {TC_PART(EXIT_STATE)};
+static const TcPart TLE_PARTS[] = {TC_PART(TLE_1), TC_PART(TLE_2), TC_PART(TLE_3), TC_PART(TLE_4), TC_PART(TLE_5)};
+static const TcPart ADCS_CALIBRATION_PARTS[] = {TC_PART(ADCS_CALIBRATION_1), TC_PART(ADCS_CALIBRATION_2), TC_PART(ADCS_CALIBRATION_3)};
+static const TcPart SEND_DATA_PARTS[] = {TC_PART(SEND_DATA)};
+static const TcPart CHANGE_TIMEOUT_PARTS[] = {TC_PART(CHANGE_TIMEOUT)};
+static const TcPart ACTIVATE_PAYLOAD_PARTS[] = {TC_PART(ACTIVATE_PAYLOAD)};
+static const TcPart UPLINK_CONFIG_PARTS[] = {TC_PART(UPLINK_CONFIG)};
+#define TC_PARTS(p) p, sizeof(p) / sizeof(TcPart)
+
+// indexed by TcId
+static const TcDescriptor DESCRIPTORS[TC_COUNT] = {
+  //command, name,               opcode, parts,                            copies, timestamp, spacing, reply
+  {"1",  "RESET",                0x01, TC_PARTS(NO_PAYLOAD),               1, true,  0,   TC_REPLY_NONE},
+  {"2",  "EXIT STATE",           0x02, TC_PARTS(EXIT_STATE_PARTS),         1, true,  0,   TC_REPLY_NONE},
+  {"10", "TLE",                  0x0A, TC_PARTS(TLE_PARTS),                1, true,  200, TC_REPLY_NONE},
+  {"11", "ADCS CALIBRATION",     0x0B, TC_PARTS(ADCS_CALIBRATION_PARTS),   1, true,  500, TC_REPLY_NONE},
+  {"20", "SEND DATA",            0x14, TC_PARTS(SEND_DATA_PARTS),          1, true,  0,   TC_REPLY_DATA},
+  {"21", "SEND TELEMETRY",       0x15, TC_PARTS(NO_PAYLOAD),               1, true,  0,   TC_REPLY_TELEMETRY},
+  {"22", "STOP SENDING DATA",    0x16, TC_PARTS(NO_PAYLOAD),               1, true,  0,   TC_REPLY_NONE},
+  {"23", "CHANGE TIMEOUT",       0x17, TC_PARTS(CHANGE_TIMEOUT_PARTS),     1, true,  0,   TC_REPLY_NONE},
+  {"30", "ACTIVATE PAYLOAD",     0x1E, TC_PARTS(ACTIVATE_PAYLOAD_PARTS),   1, true,  0,   TC_REPLY_NONE},
+  {"40", "SEND CONFIG",          0x28, TC_PARTS(NO_PAYLOAD),               1, true,  0,   TC_REPLY_CONFIG},
+  {"41", "UPLINK CONFIG",        0x29, TC_PARTS(UPLINK_CONFIG_PARTS),      1, true,  0,   TC_REPLY_NONE},
+  {nullptr, "NACK TELEMETRY",    0x19, TC_PARTS(NO_PAYLOAD),               2, false, 500, TC_REPLY_NONE},
+  {nullptr, "NACK CONFIG",       0x1A, TC_PARTS(NO_PAYLOAD),               2, false, 500, TC_REPLY_NONE},
+};
+
+const TcDescriptor* Telecommands::find(const char* command)
+{
+  for (uint8_t id = 0; id < TC_COUNT; id++)
+    if (DESCRIPTORS[id].command && !strcmp(DESCRIPTORS[id].command, command))
+      return &DESCRIPTORS[id];
+  return nullptr;
+}
+
+// Entry point of the serial and web consoles, false when the command is not a telecommand
+bool Telecommands::command(const char* command)
+{
+  const TcDescriptor* tc = find(command);
+  if (!tc)
+    return false;
+
+  if (!ConfigManager::getInstance().getAllowTx())
+  {
+    Log::console(PSTR("Radio transmission is not allowed by config! Check your config on the web panel and make sure transmission is allowed by local regulations"));
+  }
+  else if (commandSent && millis() - lastCommandTime < COMMAND_INTERVAL)
+  {
+    Log::console(PSTR("Please wait a few seconds to send another test packet."));
+  }
+  else
+  {
+    send((TcId)(tc - DESCRIPTORS));
+    lastCommandTime = millis();
+    commandSent = true;
+  }
+  return true;
+}
+
+void Telecommands::send(TcId id)
+{
+  const TcDescriptor& tc = DESCRIPTORS[id];
+  // an unfinished download is resumed by acknowledging what is already here
+  if (tc.reply == TC_REPLY_DATA && DataSession::getInstance().resume())
+    return;
+
+  // only uplinks are gated, a test packet is for nearby stations
+  if (!Orbit::getInstance().txAllowed())
+  {
+    Log::console(PSTR("%s TC not sent, satellite at %.1f deg is below the minimum elevation"), tc.name, Orbit::getInstance().getLook().elevation);
+    return;
+  }
+
+  // queued, the radio task spaces them and listens in between
+  Radio& radio = Radio::getInstance();
+  uint8_t buffer[256];
+  for (uint8_t part = 0; part < tc.partCount; part++)
+  {
+    size_t size = frame(id, part, buffer);
+    // 0 when the TC could not be framed, see build()
+    int16_t state = size ? radio.sendTx(buffer, size, tc.copies, tc.spacing * 1000) : ERR_PACKET_TOO_LONG;
+    if (state != ERR_NONE)
+    {
+      Log::console(PSTR("%s TC not sent, packet %u of %u refused (%d)"), tc.name, part + 1, tc.partCount, state);
+      return;
+    }
+  }
+
+  // the reply is only expected once the TC is on its way
+  switch (tc.reply)
+  {
+    case TC_REPLY_TELEMETRY: send_telemetry = true; break;
+    case TC_REPLY_CONFIG: send_config = true; break;
+    case TC_REPLY_DATA: DataSession::getInstance().start(); break;
+    default: break;
+  }
+
+  if (tc.partCount > 1)
+    Log::console(PSTR("Sending %s TC, %u packets!"), tc.name, tc.partCount);
+  else
+    Log::console(PSTR("Sending %s TC packet!"), tc.name);
+}
+
+// Copies the cached frame of one part into out, stamped with the current time.
+// Returns 0 when there is no frame to send
+size_t Telecommands::frame(TcId id, uint8_t part, uint8_t* out)
+{
+  RadioLock lock; // the RX path sends NACKs while the consoles send commands
+  if (!prepare())
+    return 0;
+  const CachedFrame& cf = frames[id][part];
+  memcpy(out, arena + cf.offset, cf.size);
+  if (!cf.size || !cf.stampOffset)
+    return cf.size;
+
+  uint32_t unixTime32 = (uint32_t)time(NULL);
+  uint8_t delta[256];
+  size_t deltaLength = cf.messageLength - cf.stampOffset;
+  memset(delta, 0, deltaLength);
+  delta[0] = (unixTime32 >> 24) & 0xFF;
+  delta[1] = (unixTime32 >> 16) & 0xFF;
+  delta[2] = (unixTime32 >> 8) & 0xFF;
+  delta[3] = unixTime32 & 0xFF;
+
+  // the bytes ahead of the time are zero in the delta and leave the LFSR untouched
+  uint8_t codeword[256 + NPAR];
+  rs_state rs;
+  rs_init_state(&rs);
+  encode_data(&rs, delta, deltaLength, codeword);
+  for (uint8_t i = 0; i < 4; i++)
+    out[cf.stampPos[i]] = delta[i];
+  for (uint8_t i = 0; i < NPAR; i++)
+    out[cf.parityPos[i]] ^= codeword[deltaLength + i];
+  return cf.size;
+}
+
+// Frames an arbitrary TC the same way, for the ones built at run time
+size_t Telecommands::encode(const uint8_t* tc, size_t length, uint8_t* encoded)
+{
+  size_t size;
+  {
+    RadioLock lock; // the modem layout is rewritten under it
+    size = build(tc, length, encoded);
+  }
+  Log::console(PSTR("Packet reed solomon encoded and interleaved (%u bytes)"), size);
+  return size;
+}
+
+// (Re)builds every frame when the modem layout changed, with the time bytes zeroed.
+// Returns false when there is no memory for the frames
+bool Telecommands::prepare()
+{
+  if (prepared && preparedDepth == status.modeminfo.interleaverDepth && preparedHeader == status.modeminfo.lengthHeader)
+    return true;
+
+  Radio& radio = Radio::getInstance();
+  radio.initCodecs(); // no-op once the radio is up
+
+  size_t total = 0;
+  uint8_t count = 0;
+  for (uint8_t id = 0; id < TC_COUNT; id++)
+    for (uint8_t part = 0; part < DESCRIPTORS[id].partCount; part++)
+    {
+      total += frameSize(sizeof(HEADER) + 1 + DESCRIPTORS[id].parts[part].length + (DESCRIPTORS[id].timestamp ? 4 : 0));
+      count++;
+    }
+  if (total > arenaSize)
+  {
+    free(arena);
+    arena = (uint8_t*)malloc(total);
+    arenaSize = arena ? total : 0;
+    if (!arena)
+    {
+      prepared = false;
+      Log::console(PSTR("Telecommands not encoded, no memory for %u bytes"), total);
+      return false;
+    }
+  }
+
+  size_t header = status.modeminfo.lengthHeader ? Radio::LENGTH_HEADER_SIZE : 0;
+  uint16_t offset = 0;
+  uint8_t message[256];
+  for (uint8_t id = 0; id < TC_COUNT; id++)
+  {
+    const TcDescriptor& tc = DESCRIPTORS[id];
+    for (uint8_t part = 0; part < tc.partCount; part++)
+    {
+      CachedFrame& cf = frames[id][part];
+      size_t length = sizeof(HEADER);
+      memcpy(message, HEADER, sizeof(HEADER));
+      message[length++] = tc.opcode;
+      memcpy(message + length, tc.parts[part].payload, tc.parts[part].length);
+      length += tc.parts[part].length;
+      cf.stampOffset = 0;
+      if (tc.timestamp)
+      {
+        cf.stampOffset = length;
+        memset(message + length, 0, 4);
+        length += 4;
+        for (uint8_t i = 0; i < 4; i++)
+          cf.stampPos[i] = radio.deinterleaveSource(header + cf.stampOffset + i);
+      }
+      cf.messageLength = length;
+      for (uint8_t i = 0; i < NPAR; i++)
+        cf.parityPos[i] = radio.deinterleaveSource(header + length + i);
+      cf.offset = offset;
+      cf.size = build(message, length, arena + offset);
+      offset += cf.size;
+    }
+  }
+
+  prepared = true;
+  preparedDepth = status.modeminfo.interleaverDepth;
+  preparedHeader = status.modeminfo.lengthHeader;
+  Log::console(PSTR("Telecommands pre-encoded, %u frames in %u bytes"), count, total);
+  return true;
+}
+
+// Interleaved frame length of a message, see build()
+size_t Telecommands::frameSize(size_t length)
+{
+  size_t size = length + NPAR + (status.modeminfo.lengthHeader ? Radio::LENGTH_HEADER_SIZE : 1);
+  size_t interBlock = Radio::getInstance().interleaverBlock();
+  size = (size + interBlock - 1) / interBlock * interBlock;
+  return size > Radio::TX_PACKET_SIZE ? Radio::TX_PACKET_SIZE : size;
+}
+
+// RS codeword, length header or 0xFF end marker, zero padding to whole blocks, interleaved.
+// A frame padded to 256 bytes is longer than a packet, it is cut after interleaving.
+// Only padding may land past the cut, the receiver takes those bytes as erasures
+size_t Telecommands::build(const uint8_t* tc, size_t length, uint8_t* out)
+{
+  Radio& radio = Radio::getInstance();
+  unsigned char message[256];
+  unsigned char codeword[256 + NPAR];
+  size_t header = status.modeminfo.lengthHeader ? Radio::LENGTH_HEADER_SIZE : 0;
+  size_t used = length + NPAR + (header ? header : 1);
+  bool fits = used <= Radio::TX_PACKET_SIZE;
+  for (size_t i = 0; fits && i < used; i++)
+    fits = radio.deinterleaveSource(i) < Radio::TX_PACKET_SIZE;
+  if (!fits)
+  {
+    Log::error(PSTR("TC of %u bytes does not fit a radio packet"), length);
+    return 0;
+  }
+
+  memcpy(message, tc, length);
+  rs_state rs;
+  rs_init_state(&rs);
+  encode_data(&rs, message, length, codeword + header);
+  size_t size = length + NPAR;
+
+  //the receiver finds the codeword length in the header, or by the 0xFF marker after it
+  if (header)
+  {
+    memset(codeword, size, header);
+    size += header;
+  }
+  else
+    codeword[size++] = 0xFF;
+  size_t interBlock = radio.interleaverBlock();
+  while (size % interBlock != 0)
+    codeword[size++] = 0;
+
+  radio.interleave(codeword, size);
+  if (size > Radio::TX_PACKET_SIZE)
+    size = Radio::TX_PACKET_SIZE;
+  memcpy(out, codeword, size);
+  return size;
+}
@@ -0,0 +1,116 @@
+/*
+  Telecommands.h - Table of the telecommands the station can uplink, pre-encoded once
+
+  Copyright (C) 2020 -2021 @G4lile0, @gmag12 and @dev_4m1g0
+
+  This program is free software: you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 3 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef TELECOMMANDS_H
+#define TELECOMMANDS_H
+
+#include <Arduino.h>
+#include "correct/rs/ecc.h"
+
+enum TcId : uint8_t {
+  TC_RESET,
+  TC_EXIT_STATE,
+  TC_TLE,
+  TC_ADCS_CALIBRATION,
+  TC_SEND_DATA,
+  TC_SEND_TELEMETRY,
+  TC_STOP_SENDING_DATA,
+  TC_CHANGE_TIMEOUT,
+  TC_ACTIVATE_PAYLOAD,
+  TC_SEND_CONFIG,
+  TC_UPLINK_CONFIG,
+  TC_NACK_TELEMETRY,
+  TC_NACK_CONFIG,
+  TC_COUNT
+};
+
+// what the satellite is expected to answer, the RX path handles the reply
+enum TcReply : uint8_t {
+  TC_REPLY_NONE,
+  TC_REPLY_DATA,
+  TC_REPLY_TELEMETRY,
+  TC_REPLY_CONFIG
+};
+
+struct TcPart {
+  const uint8_t* payload; // bytes after the opcode
+  uint8_t length;
+};
+
+struct TcDescriptor {
+  const char* command;    // serial and web console command, nullptr when only sent by the firmware
+  const char* name;
+  uint8_t opcode;
+  const TcPart* parts;    // sent in order, each one in its own frame
+  uint8_t partCount;
+  uint8_t copies;         // times each part goes on air
+  bool timestamp;         // the unix time is appended to every part when sent
+  uint16_t spacing;       // ms between frames
+  TcReply reply;
+};
+
+// Every telecommand is header + opcode + payload (+ unix time), RS encoded,
+// framed and interleaved exactly like ConfigManager used to do on each send.
+// All of that is done once per modem layout with the timestamp bytes zeroed.
+// RS is linear and the interleaver is a fixed permutation, so sending only
+// copies the cached frame, drops the four time bytes in place and xors in
+// the parity of those four bytes alone.
+class Telecommands {
+public:
+  static Telecommands& getInstance()
+  {
+    static Telecommands instance;
+    return instance;
+  }
+  static const uint8_t HEADER[2];
+  const TcDescriptor* find(const char* command);
+  bool command(const char* command);
+  void send(TcId id);
+  size_t frame(TcId id, uint8_t part, uint8_t* out);
+  size_t encode(const uint8_t* tc, size_t length, uint8_t* encoded);
+
+private:
+  Telecommands() {};
+  struct CachedFrame {
+    uint16_t offset;               // into the arena
+    uint16_t size;                 // interleaved frame, what goes on air
+    uint8_t stampOffset;           // of the unix time in the RS message, 0 when not stamped
+    uint8_t messageLength;
+    uint8_t stampPos[4];           // where the time and parity bytes land once interleaved
+    uint8_t parityPos[NPAR];
+  };
+
+  bool prepare();
+  size_t build(const uint8_t* tc, size_t length, uint8_t* out);
+  size_t frameSize(size_t length);
+
+  static const uint8_t MAX_PARTS = 5;
+  static const uint32_t COMMAND_INTERVAL = 20 * 1000; // ms between commands from the consoles
+
+  CachedFrame frames[TC_COUNT][MAX_PARTS];
+  uint8_t* arena = nullptr;
+  size_t arenaSize = 0;
+  bool prepared = false;
+  uint8_t preparedDepth = 0;       // modem layout the cache was built for
+  bool preparedHeader = false;
+  unsigned long lastCommandTime = 0;
+  bool commandSent = false;
+};
+
+#endif
@@ -0,0 +1,193 @@
+#include "acs.h"
+
+// butterfly b joins the predecessors b (low) and b + n (high), n = num_butterflies,
+//   into the successors 2b (new bit 0) and 2b + 1 (new bit 1)
+// this is the same walk convolutional_decode_inner does through pair_lookup:
+//   the low predecessor emits table[2b] / table[2b + 1] and the high one
+//   table[2b + 2n] / table[2b + 2n + 1]
+static inline unsigned int acs_mask_index(const acs_lookup_t *acs, unsigned int bit,
+                                          unsigned int parity, unsigned int high) {
+    return ((bit * 2 + parity) * 2 + high) * (acs->num_butterflies / 2);
+}
+
+acs_lookup_t acs_lookup_create(unsigned int rate, unsigned int order, const unsigned int *table) {
+    acs_lookup_t acs;
+    acs.rate = rate;
+    acs.num_butterflies = (order >= 2) ? 1 << (order - 2) : 0;
+    acs.masks = NULL;
+
+    if (!acs.num_butterflies || acs.num_butterflies % ACS_LANES || rate > 8) {
+        return acs;
+    }
+
+    unsigned int n = acs.num_butterflies;
+    acs.masks = calloc(rate * 4 * (n / 2), sizeof(uint32_t));
+    for (unsigned int bit = 0; bit < rate; bit++) {
+        for (unsigned int parity = 0; parity < 2; parity++) {
+            for (unsigned int high = 0; high < 2; high++) {
+                uint32_t *masks = acs.masks + acs_mask_index(&acs, bit, parity, high);
+                for (unsigned int b = 0; b < n; b++) {
+                    unsigned int out = table[2 * b + parity + (high ? 2 * n : 0)];
+                    uint32_t lane = ((out >> bit) & 1) ? 0xffff : 0;
+                    masks[b / 2] |= lane << (16 * (b & 1));
+                }
+            }
+        }
+    }
+    return acs;
+}
+
+void acs_lookup_destroy(acs_lookup_t acs) {
+    free(acs.masks);
+}
+
+#if defined(__AVX2__)
+
+static inline __m256i acs_branch(const acs_lookup_t *acs, const __m256i *symbols, __m256i scale,
+                                 unsigned int parity, unsigned int high, unsigned int b) {
+    __m256i metric = _mm256_setzero_si256();
+    for (unsigned int k = 0; k < acs->rate; k++) {
+        const uint32_t *masks = acs->masks + acs_mask_index(acs, k, parity, high) + b / 2;
+        __m256i mask = _mm256_loadu_si256((const __m256i *)masks);
+        metric = _mm256_add_epi16(metric, _mm256_xor_si256(symbols[k], _mm256_and_si256(mask, scale)));
+    }
+    return metric;
+}
+
+void acs_slice(const acs_lookup_t *acs, const uint8_t *symbols, distance_t scale,
+               const distance_t *read_errors, distance_t *write_errors, uint8_t *history) {
+    unsigned int n = acs->num_butterflies;
+    __m256i symbol_v[8];
+    for (unsigned int k = 0; k < acs->rate; k++) {
+        symbol_v[k] = _mm256_set1_epi16(symbols[k]);
+    }
+    __m256i scale_v = _mm256_set1_epi16(scale);
+    __m256i zero = _mm256_setzero_si256();
+    __m256i one = _mm256_set1_epi16(1);
+
+    for (unsigned int b = 0; b < n; b += 16) {
+        __m256i low_past = _mm256_loadu_si256((const __m256i *)(read_errors + b));
+        __m256i high_past = _mm256_loadu_si256((const __m256i *)(read_errors + n + b));
+        __m256i best[2], chose_high[2];
+        for (unsigned int parity = 0; parity < 2; parity++) {
+            __m256i low = _mm256_adds_epu16(low_past, acs_branch(acs, symbol_v, scale_v, parity, 0, b));
+            __m256i high = _mm256_adds_epu16(high_past, acs_branch(acs, symbol_v, scale_v, parity, 1, b));
+            // low - high saturates to 0 exactly when low <= high, which keeps low on a tie
+            __m256i excess = _mm256_subs_epu16(low, high);
+            best[parity] = _mm256_sub_epi16(low, excess);
+            chose_high[parity] = _mm256_andnot_si256(_mm256_cmpeq_epi16(excess, zero), one);
+        }
+        // successors 2b + parity, the unpacks work per 128 bit half so put the halves back in order
+        __m256i lo = _mm256_unpacklo_epi16(best[0], best[1]);
+        __m256i hi = _mm256_unpackhi_epi16(best[0], best[1]);
+        _mm256_storeu_si256((__m256i *)(write_errors + 2 * b), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(write_errors + 2 * b + 16), _mm256_permute2x128_si256(lo, hi, 0x31));
+        lo = _mm256_unpacklo_epi16(chose_high[0], chose_high[1]);
+        hi = _mm256_unpackhi_epi16(chose_high[0], chose_high[1]);
+        __m256i bytes = _mm256_packus_epi16(_mm256_permute2x128_si256(lo, hi, 0x20),
+                                            _mm256_permute2x128_si256(lo, hi, 0x31));
+        _mm256_storeu_si256((__m256i *)(history + 2 * b), _mm256_permute4x64_epi64(bytes, 0xd8));
+    }
+}
+
+#elif defined(__SSE2__)
+
+static inline __m128i acs_branch(const acs_lookup_t *acs, const __m128i *symbols, __m128i scale,
+                                 unsigned int parity, unsigned int high, unsigned int b) {
+    __m128i metric = _mm_setzero_si128();
+    for (unsigned int k = 0; k < acs->rate; k++) {
+        const uint32_t *masks = acs->masks + acs_mask_index(acs, k, parity, high) + b / 2;
+        __m128i mask = _mm_loadu_si128((const __m128i *)masks);
+        metric = _mm_add_epi16(metric, _mm_xor_si128(symbols[k], _mm_and_si128(mask, scale)));
+    }
+    return metric;
+}
+
+void acs_slice(const acs_lookup_t *acs, const uint8_t *symbols, distance_t scale,
+               const distance_t *read_errors, distance_t *write_errors, uint8_t *history) {
+    unsigned int n = acs->num_butterflies;
+    __m128i symbol_v[8];
+    for (unsigned int k = 0; k < acs->rate; k++) {
+        symbol_v[k] = _mm_set1_epi16(symbols[k]);
+    }
+    __m128i scale_v = _mm_set1_epi16(scale);
+    __m128i zero = _mm_setzero_si128();
+    __m128i one = _mm_set1_epi16(1);
+
+    for (unsigned int b = 0; b < n; b += 8) {
+        __m128i low_past = _mm_loadu_si128((const __m128i *)(read_errors + b));
+        __m128i high_past = _mm_loadu_si128((const __m128i *)(read_errors + n + b));
+        __m128i best[2], chose_high[2];
+        for (unsigned int parity = 0; parity < 2; parity++) {
+            __m128i low = _mm_adds_epu16(low_past, acs_branch(acs, symbol_v, scale_v, parity, 0, b));
+            __m128i high = _mm_adds_epu16(high_past, acs_branch(acs, symbol_v, scale_v, parity, 1, b));
+            // low - high saturates to 0 exactly when low <= high, which keeps low on a tie
+            __m128i excess = _mm_subs_epu16(low, high);
+            best[parity] = _mm_sub_epi16(low, excess);
+            chose_high[parity] = _mm_andnot_si128(_mm_cmpeq_epi16(excess, zero), one);
+        }
+        // successors 2b + parity
+        _mm_storeu_si128((__m128i *)(write_errors + 2 * b), _mm_unpacklo_epi16(best[0], best[1]));
+        _mm_storeu_si128((__m128i *)(write_errors + 2 * b + 8), _mm_unpackhi_epi16(best[0], best[1]));
+        _mm_storeu_si128((__m128i *)(history + 2 * b),
+                         _mm_packus_epi16(_mm_unpacklo_epi16(chose_high[0], chose_high[1]),
+                                          _mm_unpackhi_epi16(chose_high[0], chose_high[1])));
+    }
+}
+
+#else
+
+// two 16-bit lanes per word. the renormalize interval keeps every metric far
+// enough from 0xffff that lanes never carry into each other
+#define ACS_LANE_TOP 0x80008000u
+
+static inline uint32_t acs_pack(const distance_t *d) {
+    return d[0] | ((uint32_t)d[1] << 16);
+}
+
+static inline uint32_t acs_branch(const acs_lookup_t *acs, const uint32_t *symbols, uint32_t scale,
+                                  unsigned int parity, unsigned int high, unsigned int pair) {
+    uint32_t metric = 0;
+    for (unsigned int k = 0; k < acs->rate; k++) {
+        metric += symbols[k] ^ (acs->masks[acs_mask_index(acs, k, parity, high) + pair] & scale);
+    }
+    return metric;
+}
+
+// 0xffff in the lanes where high < low, the scalar decoder keeps low on a tie
+static inline uint32_t acs_chose_high(uint32_t low, uint32_t high) {
+    // compare the low 15 bits with the top bit of each lane as a borrow stop,
+    // then let the top bits decide where they differ
+    uint32_t low_bits = ((high | ACS_LANE_TOP) - (low & ~ACS_LANE_TOP)) & ACS_LANE_TOP;
+    uint32_t high_ge_low = ((high & ~low) | (~(high ^ low) & low_bits)) & ACS_LANE_TOP;
+    uint32_t high_lt_low = ~high_ge_low & ACS_LANE_TOP;
+    return high_lt_low | (high_lt_low - (high_lt_low >> 15));
+}
+
+void acs_slice(const acs_lookup_t *acs, const uint8_t *symbols, distance_t scale,
+               const distance_t *read_errors, distance_t *write_errors, uint8_t *history) {
+    unsigned int n = acs->num_butterflies;
+    uint32_t symbol_w[8];
+    for (unsigned int k = 0; k < acs->rate; k++) {
+        symbol_w[k] = symbols[k] * 0x00010001u;
+    }
+    uint32_t scale_w = scale * 0x00010001u;
+
+    for (unsigned int pair = 0, b = 0; b < n; pair++, b += 2) {
+        uint32_t low_past = acs_pack(read_errors + b);
+        uint32_t high_past = acs_pack(read_errors + n + b);
+        for (unsigned int parity = 0; parity < 2; parity++) {
+            uint32_t low = low_past + acs_branch(acs, symbol_w, scale_w, parity, 0, pair);
+            uint32_t high = high_past + acs_branch(acs, symbol_w, scale_w, parity, 1, pair);
+            uint32_t chose_high = acs_chose_high(low, high);
+            uint32_t best = (low & ~chose_high) | (high & chose_high);
+            // lanes b and b + 1 go to successors 2b + parity and 2b + 2 + parity
+            write_errors[2 * b + parity] = (distance_t)best;
+            write_errors[2 * b + 2 + parity] = (distance_t)(best >> 16);
+            history[2 * b + parity] = chose_high & 1;
+            history[2 * b + 2 + parity] = (chose_high >> 16) & 1;
+        }
+    }
+}
+
+#endif
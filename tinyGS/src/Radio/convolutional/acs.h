@@ -0,0 +1,36 @@
+#ifndef CORRECT_CONVOLUTIONAL_ACS
+#define CORRECT_CONVOLUTIONAL_ACS
+#include "../correct/convolutional.h"
+
+// add-compare-select over a whole trellis slice, several states per operation
+// the kernel is picked at compile time: AVX2 (16 states), SSE2 (8) or
+// portable SWAR with two 16-bit metrics packed in a uint32_t
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ACS_LANES 16
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define ACS_LANES 8
+#else
+#define ACS_LANES 2
+#endif
+
+// the branch metric of a state is sum over the rate output bits k of
+//   symbol[k] ^ (output bit k ? scale : 0)
+// with scale 1 and 0/1 symbols that is the hamming distance, with scale 255 and
+// soft symbols it is metric_soft_distance_linear, so both match the scalar path
+// exactly. masks holds the 0/0xffff output bit of every butterfly lane, packed
+// two lanes per word, for (bit, successor parity, low/high predecessor)
+typedef struct {
+    uint32_t *masks;
+    unsigned int rate;
+    unsigned int num_butterflies;
+} acs_lookup_t;
+
+// returns a lookup with masks == NULL when the code doesn't fit the kernel
+acs_lookup_t acs_lookup_create(unsigned int rate, unsigned int order, const unsigned int *table);
+void acs_lookup_destroy(acs_lookup_t acs);
+
+void acs_slice(const acs_lookup_t *acs, const uint8_t *symbols, distance_t scale,
+               const distance_t *read_errors, distance_t *write_errors, uint8_t *history);
+#endif
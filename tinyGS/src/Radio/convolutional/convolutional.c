@@ -49,6 +49,7 @@ void _correct_convolutional_teardown(correct_convolutional *conv) {
     bit_reader_destroy(conv->bit_reader);
     if (conv->has_init_decode) {
         pair_lookup_destroy(conv->pair_lookup);
+        acs_lookup_destroy(conv->acs);
         history_buffer_destroy(conv->history_buffer);
         error_buffer_destroy(conv->errors);
         free(conv->distances);
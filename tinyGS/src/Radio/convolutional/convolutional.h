@@ -4,6 +4,7 @@
 #include "bit.h"
 #include "metric.h"
 #include "lookup.h"
+#include "acs.h"
 #include "history_buffer.h"
 #include "error_buffer.h"
 
@@ -18,6 +19,7 @@ struct correct_convolutional {
     bool has_init_decode;
     distance_t *distances;
     pair_lookup_t pair_lookup;
+    acs_lookup_t acs;
     soft_measurement_t soft_measurement;
     history_buffer *history_buffer;
     error_buffer_t *errors;
@@ -60,7 +60,29 @@ void convolutional_decode_warmup(correct_convolutional *conv, unsigned int sets,
 void convolutional_decode_inner(correct_convolutional *conv, unsigned int sets,
                                 const uint8_t *soft) {
     shift_register_t highbit = 1 << (conv->order - 1);
+    bool packed = conv->acs.masks && (!soft || conv->soft_measurement == CORRECT_SOFT_LINEAR);
     for (unsigned int i = conv->order - 1; i < (sets - conv->order + 1); i++) {
+        if (packed) {
+            // the packed kernel works out its own branch metrics from the symbols
+            uint8_t hard[8];
+            const uint8_t *symbols = hard;
+            distance_t scale = 1;
+            if (soft) {
+                symbols = soft + i * conv->rate;
+                scale = soft_max;
+            } else {
+                unsigned int out = bit_reader_read(conv->bit_reader, conv->rate);
+                for (unsigned int k = 0; k < conv->rate; k++) {
+                    hard[k] = (out >> k) & 1;
+                }
+            }
+            acs_slice(&conv->acs, symbols, scale, conv->errors->read_errors, conv->errors->write_errors,
+                      history_buffer_get_slice(conv->history_buffer));
+            history_buffer_process(conv->history_buffer, conv->errors->write_errors, conv->bit_writer);
+            error_buffer_swap(conv->errors);
+            continue;
+        }
+
         distance_t *distances = conv->distances;
         // lasterrors are the aggregate bit errors for the states of shiftregister for the previous
         // time slice
@@ -252,6 +274,7 @@ void _convolutional_decode_init(correct_convolutional *conv, unsigned int min_tr
 
     conv->distances = calloc(1 << (conv->rate), sizeof(distance_t));
     conv->pair_lookup = pair_lookup_create(conv->rate, conv->order, conv->table);
+    conv->acs = acs_lookup_create(conv->rate, conv->order, conv->table);
 
     conv->soft_measurement = CORRECT_SOFT_LINEAR;
 
@@ -267,7 +290,9 @@ static ssize_t _convolutional_decode(correct_convolutional *conv, size_t num_enc
                                      const soft_t *soft_encoded) {
     if (!conv->has_init_decode) {
         uint64_t max_error_per_input = conv->rate * soft_max;
-        unsigned int renormalize_interval = distance_max / max_error_per_input;
+        // renormalize at half the range, the spread between states is far below the other
+        // half, so metrics never wrap and the packed acs kernels need no carry handling
+        unsigned int renormalize_interval = (distance_max / 2) / max_error_per_input;
         _convolutional_decode_init(conv, 5 * conv->order, 15 * conv->order, renormalize_interval);
     }
 
@@ -208,6 +208,58 @@ correct_reed_solomon *correct_reed_solomon_create(uint16_t primitive_polynomial,
                                                   uint8_t generator_root_gap,
                                                   size_t num_roots);
 
+/* correct_reed_solomon_tables holds the lookup tables an encoder/decoder
+ * would otherwise build in its workspace: the field exp (512 entries)
+ * and log (256) tables, the multiplication table of every generator
+ * root (num_roots rows of 256) and the first num_roots powers of every
+ * field element (256 rows of num_roots). Declared const they are
+ * placed in flash, which takes ~4k of RAM off a 6 root code.
+ */
+typedef struct {
+    uint16_t primitive_polynomial;
+    uint8_t first_consecutive_root;
+    uint8_t generator_root_gap;
+    size_t num_roots;
+    const uint8_t *exp;
+    const uint8_t *log;
+    const uint8_t *generator_root_mul;
+    const uint8_t *element_exp;
+} correct_reed_solomon_tables;
+
+// x^8 + x^4 + x^3 + x^2 + 1, first root 1, gap 1, 6 roots (the rscode TC code)
+extern const correct_reed_solomon_tables correct_rs_tables_8_4_3_2_0_6;
+
+/* Upper bound of correct_reed_solomon_workspace_size for num_roots
+ * when the tables are built in the workspace, usable to size a
+ * static buffer.
+ */
+#define CORRECT_RS_WORKSPACE_SIZE(num_roots) (2560 + 544 * (num_roots))
+
+/* correct_reed_solomon_workspace_size returns the bytes that
+ * correct_reed_solomon_create_in needs for a code with num_roots.
+ * tables may be NULL, in which case they take space in the workspace.
+ */
+size_t correct_reed_solomon_workspace_size(size_t num_roots, const correct_reed_solomon_tables *tables);
+
+/* correct_reed_solomon_create_in works like correct_reed_solomon_create
+ * but carves the instance, its encoder/decoder scratch and tables out
+ * of workspace instead of the heap. Nothing is allocated afterwards,
+ * not even while decoding. The workspace must stay valid (and unused
+ * by anything else) for as long as the instance is used. destroy is a
+ * no-op for these instances.
+ *
+ * tables may be NULL or point to precomputed tables for this same code.
+ *
+ * This function returns NULL if the workspace is too small or the
+ * tables belong to a different code.
+ */
+correct_reed_solomon *correct_reed_solomon_create_in(void *workspace, size_t workspace_size,
+                                                     uint16_t primitive_polynomial,
+                                                     uint8_t first_consecutive_root,
+                                                     uint8_t generator_root_gap,
+                                                     size_t num_roots,
+                                                     const correct_reed_solomon_tables *tables);
+
 /* correct_reed_solomon_encode uses the rs instance to encode
  * parity information onto a block of data. msg_length should be
  * no more than the payload size for one block e.g. no more
@@ -235,7 +287,8 @@ ssize_t correct_reed_solomon_encode(correct_reed_solomon *rs, const uint8_t *msg
  * errors when this function returns a positive value.
  *
  * msg should be long enough to contain a decoded payload for
- * this encoded block.
+ * this encoded block. msg may be the same buffer as encoded, the
+ * block is copied into the decoder before the payload is written.
  *
  * This function returns a positive number of bytes written to msg
  * if it has decoded or -1 if it has encountered an error.
@@ -243,6 +296,11 @@ ssize_t correct_reed_solomon_encode(correct_reed_solomon *rs, const uint8_t *msg
 ssize_t correct_reed_solomon_decode(correct_reed_solomon *rs, const uint8_t *encoded,
                                     size_t encoded_length, uint8_t *msg);
 
+/* correct_reed_solomon_corrected returns the number of symbols
+ * repaired by the last successful decode, 0 for a clean block.
+ */
+size_t correct_reed_solomon_corrected(const correct_reed_solomon *rs);
+
 /* correct_reed_solomon_decode_with_erasures uses the rs
  * instance to decode a payload from a block containing payload
  * and parity bytes. Additionally, the user can provide the
@@ -47,7 +47,8 @@ struct correct_reed_solomon {
 
     polynomial_t_rs generator;
     field_element_t *generator_roots;
-    field_logarithm_t **generator_root_exp;
+    // multiplication table of every generator root, min_distance rows of 256
+    const field_element_t *generator_root_mul;
 
     polynomial_t_rs encoded_polynomial;
     polynomial_t_rs encoded_remainder;
@@ -62,7 +63,8 @@ struct correct_reed_solomon {
     field_element_t *error_vals;
     field_logarithm_t *error_locations;
 
-    field_logarithm_t **element_exp;
+    // first min_distance powers of every field element, 256 rows of min_distance
+    const field_logarithm_t *element_exp;
 
     // scratch
     // (do no allocations at steady state)
@@ -74,7 +76,16 @@ struct correct_reed_solomon {
     polynomial_t_rs error_evaluator;
     polynomial_t_rs error_locator_derivative;
     polynomial_t_rs init_from_roots_scratch[2];
-    bool has_init_decode;
+
+    // used during erasure decoding
+    field_element_t *syndrome_copy;
+    polynomial_t_rs erasure_error_locator;
+
+    // everything above lives in one workspace, this is it when create took it from the heap
+    void *heap_workspace;
+
+    // symbols repaired by the last successful decode
+    size_t num_corrected;
 
 };
 #endif
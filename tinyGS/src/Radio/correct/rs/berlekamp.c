@@ -38,47 +38,33 @@
 #include <stdio.h>
 #include "ecc.h"
 
-/* The Error Locator Polynomial, also known as Lambda or Sigma. Lambda[0] == 1 */
-static int Lambda[MAXDEG];
-
-/* The Error Evaluator Polynomial */
-static int Omega[MAXDEG];
-
 /* local ANSI declarations */
 static int compute_discrepancy(int lambda[], int S[], int L, int n);
-static void init_gamma(int gamma[]);
-static void compute_modified_omega (void);
+static void init_gamma(const rs_state *st, int gamma[]);
+static void compute_modified_omega (rs_state *st);
 static void mul_z_poly (int src[]);
 
-/* error locations found using Chien's search*/
-static int ErrorLocs[256];
-static int NErrors;
-
-/* erasure flags */
-static int ErasureLocs[256];
-static int NErasures;
-
 /* From  Cain, Clark, "Error-Correction Coding For Digital Communications", pp. 216. */
 void
-Modified_Berlekamp_Massey (void)
+Modified_Berlekamp_Massey (rs_state *st)
 {
   int n, L, L2, k, d, i;
   int psi[MAXDEG], psi2[MAXDEG], D[MAXDEG];
   int gamma[MAXDEG];
 
   /* initialize Gamma, the erasure locator polynomial */
-  init_gamma(gamma);
+  init_gamma(st, gamma);
 
   /* initialize to z */
   copy_poly(D, gamma);
   mul_z_poly(D);
 
   copy_poly(psi, gamma);
-  k = -1; L = NErasures;
+  k = -1; L = st->NErasures;
 
-  for (n = NErasures; n < NPAR; n++) {
+  for (n = st->NErasures; n < NPAR; n++) {
 
-    d = compute_discrepancy(psi, synBytes, L, n);
+    d = compute_discrepancy(psi, st->synBytes, L, n);
 
     if (d != 0) {
 
@@ -101,8 +87,8 @@ Modified_Berlekamp_Massey (void)
     mul_z_poly(D);
   }
 
-  for(i = 0; i < MAXDEG; i++) Lambda[i] = psi[i];
-  compute_modified_omega();
+  for(i = 0; i < MAXDEG; i++) st->Lambda[i] = psi[i];
+  compute_modified_omega(st);
 
 
 }
@@ -112,14 +98,14 @@ Modified_Berlekamp_Massey (void)
    Psi*S mod z^4
   */
 void
-compute_modified_omega ()
+compute_modified_omega (rs_state *st)
 {
   int i;
   int product[MAXDEG*2];
 
-  mult_polys(product, Lambda, synBytes);
-  zero_poly(Omega);
-  for(i = 0; i < NPAR; i++) Omega[i] = product[i];
+  mult_polys(product, st->Lambda, st->synBytes);
+  zero_poly(st->Omega);
+  for(i = 0; i < NPAR; i++) st->Omega[i] = product[i];
 
 }
 
@@ -150,7 +136,7 @@ mult_polys (int dst[], int p1[], int p2[])
 
 /* gamma = product (1-z*a^Ij) for erasure locs Ij */
 void
-init_gamma (int gamma[])
+init_gamma (const rs_state *st, int gamma[])
 {
   int e, tmp[MAXDEG];
 
@@ -158,9 +144,9 @@ init_gamma (int gamma[])
   zero_poly(tmp);
   gamma[0] = 1;
 
-  for (e = 0; e < NErasures; e++) {
+  for (e = 0; e < st->NErasures; e++) {
     copy_poly(tmp, gamma);
-    scale_poly(gexp[ErasureLocs[e]], tmp);
+    scale_poly(gexp[st->ErasureLocs[e]], tmp);
     mul_z_poly(tmp);
     add_polys(gamma, tmp);
   }
@@ -234,20 +220,24 @@ static void mul_z_poly (int src[])
 
 
 void
-Find_Roots (void)
+Find_Roots (rs_state *st)
 {
   int sum, r, k;
-  NErrors = 0;
+  st->NErrors = 0;
 
   for (r = 1; r < 256; r++) {
     sum = 0;
     /* evaluate lambda at r */
     for (k = 0; k < NPAR+1; k++) {
-      sum ^= gmult(gexp[(k*r)%255], Lambda[k]);
+      sum ^= gmult(gexp[(k*r)%255], st->Lambda[k]);
     }
     if (sum == 0)
     {
-      ErrorLocs[NErrors] = (255-r); NErrors++;
+      /* more roots than MAXDEG means Lambda is bogus, keep counting so the
+       * caller rejects it but never write past ErrorLocs */
+      if (st->NErrors < MAXDEG)
+        st->ErrorLocs[st->NErrors] = (255-r);
+      st->NErrors++;
     }
   }
 }
@@ -262,49 +252,54 @@ Find_Roots (void)
  * alpha^(-i) for error locs i.
  *
  * Returns 1 if everything ok, or 0 if an out-of-bounds error is found
+ * or there are more erasures than parity bytes.
  *
  */
 
 int
-correct_errors_erasures (unsigned char codeword[],
+correct_errors_erasures (rs_state *st,
+			 unsigned char codeword[],
 			 int csize,
 			 int nerasures,
 			 int erasures[])
 {
   int r, i, j, err;
 
+  if (nerasures < 0 || nerasures > NPAR)
+    return(0);
+
   /* If you want to take advantage of erasure correction, be sure to
      set NErasures and ErasureLocs[] with the locations of erasures.
      */
-  NErasures = nerasures;
-  for (i = 0; i < NErasures; i++) ErasureLocs[i] = erasures[i];
+  st->NErasures = nerasures;
+  for (i = 0; i < st->NErasures; i++) st->ErasureLocs[i] = erasures[i];
 
-  Modified_Berlekamp_Massey();
-  Find_Roots();
+  Modified_Berlekamp_Massey(st);
+  Find_Roots(st);
 
 
-  if ((NErrors <= NPAR) && NErrors > 0) {
+  if ((st->NErrors <= NPAR) && st->NErrors > 0) {
 
     /* first check for illegal error locs */
-    for (r = 0; r < NErrors; r++) {
-      if (ErrorLocs[r] >= csize) {
+    for (r = 0; r < st->NErrors; r++) {
+      if (st->ErrorLocs[r] >= csize) {
 	      return(0);
       }
     }
 
-    for (r = 0; r < NErrors; r++) {
+    for (r = 0; r < st->NErrors; r++) {
       int num, denom;
-      i = ErrorLocs[r];
+      i = st->ErrorLocs[r];
       /* evaluate Omega at alpha^(-i) */
 
       num = 0;
       for (j = 0; j < MAXDEG; j++)
-	      num ^= gmult(Omega[j], gexp[((255-i)*j)%255]);
+	      num ^= gmult(st->Omega[j], gexp[((255-i)*j)%255]);
 
       /* evaluate Lambda' (derivative) at alpha^(-i) ; all odd powers disappear */
       denom = 0;
       for (j = 1; j < MAXDEG; j += 2) {
-	      denom ^= gmult(Lambda[j], gexp[((255-i)*(j-1)) % 255]);
+	      denom ^= gmult(st->Lambda[j], gexp[((255-i)*(j-1)) % 255]);
       }
 
       err = gmult(num, ginv(denom));
@@ -2,6 +2,11 @@
 extern "C"{
 #endif 
 
+#ifndef ECC_H
+#define ECC_H
+
+#include <stdint.h>
+
 /* Reed Solomon Coding for glyphs
  * Copyright Henry Minsky (hqm@alum.mit.edu) 1991-2009
  *
@@ -60,25 +65,44 @@ extern "C"{
 #define MAXDEG (NPAR*2)
 
 /*************************************/
-/* Encoder parity bytes */
-extern int pBytes[MAXDEG];
+/* Working state of one encoder/decoder. Every routine below takes it
+ * explicitly, so independent contexts can be used from different tasks. */
+typedef struct {
+  /* Encoder parity bytes */
+  int pBytes[MAXDEG];
+
+  /* Decoder syndrome bytes */
+  int synBytes[MAXDEG];
+
+  /* The Error Locator Polynomial, also known as Lambda or Sigma. Lambda[0] == 1 */
+  int Lambda[MAXDEG];
 
-/* Decoder syndrome bytes */
-extern int synBytes[MAXDEG];
+  /* The Error Evaluator Polynomial */
+  int Omega[MAXDEG];
+
+  /* error locations found using Chien's search */
+  int ErrorLocs[MAXDEG];
+  int NErrors;
+
+  /* erasure flags */
+  int ErasureLocs[MAXDEG];
+  int NErasures;
+} rs_state;
 
 /* print debugging info */
 //extern int DEBUG;
 
 /* Reed Solomon encode/decode routines */
 void initialize_ecc (void);
-int check_syndrome (void);
-void decode_data (unsigned char data[], int nbytes);
-void encode_data (unsigned char msg[], int nbytes, unsigned char dst[]);
+void rs_init_state (rs_state *st);
+int check_syndrome (const rs_state *st);
+void decode_data (rs_state *st, unsigned char data[], int nbytes);
+void encode_data (rs_state *st, unsigned char msg[], int nbytes, unsigned char dst[]);
 
 
 /* galois arithmetic tables */
-extern int gexp[];
-extern int glog[];
+extern const uint8_t gexp[];
+extern const uint8_t glog[];
 
 void init_galois_tables (void);
 int ginv(int elt);
@@ -86,7 +110,7 @@ int gmult(int a, int b);
 
 
 /* Error location routines */
-int correct_errors_erasures (unsigned char codeword[], int csize,int nerasures, int erasures[]);
+int correct_errors_erasures (rs_state *st, unsigned char codeword[], int csize,int nerasures, int erasures[]);
 
 /* polynomial arithmetic */
 void add_polys(int dst[], int src[]) ;
@@ -96,6 +120,8 @@ void mult_polys(int dst[], int p1[], int p2[]);
 void copy_poly(int dst[], int src[]);
 void zero_poly(int poly[]);
 
+#endif /* ECC_H */
+
 #ifdef __cplusplus
 }
 #endif
@@ -26,21 +26,102 @@
 
 #include <stdio.h>
 #include <ctype.h>
+#include <string.h>
 #include "ecc.h"
 
-/* Encoder parity bytes */
-int pBytes[MAXDEG];
-
-/* Decoder syndrome bytes */
-int synBytes[MAXDEG];
-
-/* generator polynomial */
-int genPoly[MAXDEG*2];
+/* generator polynomial, prod(x + a^n) for n = 1 to NPAR, lowest order first.
+ * Only needed to build parityTable or for the NPAR > 8 LFSR fallback; the
+ * NPAR == 6 table below already has it folded in. */
+#if NPAR != 6
+static int genPoly[MAXDEG*2];
+#endif
+
+/* Parity contribution of every LFSR feedback byte: byte j of entry fb is
+ * genPoly[j]*fb, so a single lookup and XOR advances all NPAR parity bytes
+ * at once. Only possible while the whole register fits in a uint64_t. */
+#if NPAR <= 8
+#if NPAR == 6
+static const uint64_t parityTable[256] = {
+  0x000000000000ULL, 0x7e049e3a3175ULL, 0xfc08217462eaULL, 0x820cbf4e539fULL,
+  0xe51042e8c4c9ULL, 0x9b14dcd2f5bcULL, 0x1918639ca623ULL, 0x671cfda69756ULL,
+  0xd72084cd958fULL, 0xa9241af7a4faULL, 0x2b28a5b9f765ULL, 0x552c3b83c610ULL,
+  0x3230c6255146ULL, 0x4c34581f6033ULL, 0xce38e75133acULL, 0xb03c796b02d9ULL,
+  0xb34015873703ULL, 0xcd448bbd0676ULL, 0x4f4834f355e9ULL, 0x314caac9649cULL,
+  0x5650576ff3caULL, 0x2854c955c2bfULL, 0xaa58761b9120ULL, 0xd45ce821a055ULL,
+  0x6460914aa28cULL, 0x1a640f7093f9ULL, 0x9868b03ec066ULL, 0xe66c2e04f113ULL,
+  0x8170d3a26645ULL, 0xff744d985730ULL, 0x7d78f2d604afULL, 0x037c6cec35daULL,
+  0x7b802a136e06ULL, 0x0584b4295f73ULL, 0x87880b670cecULL, 0xf98c955d3d99ULL,
+  0x9e9068fbaacfULL, 0xe094f6c19bbaULL, 0x6298498fc825ULL, 0x1c9cd7b5f950ULL,
+  0xaca0aedefb89ULL, 0xd2a430e4cafcULL, 0x50a88faa9963ULL, 0x2eac1190a816ULL,
+  0x49b0ec363f40ULL, 0x37b4720c0e35ULL, 0xb5b8cd425daaULL, 0xcbbc53786cdfULL,
+  0xc8c03f945905ULL, 0xb6c4a1ae6870ULL, 0x34c81ee03befULL, 0x4acc80da0a9aULL,
+  0x2dd07d7c9dccULL, 0x53d4e346acb9ULL, 0xd1d85c08ff26ULL, 0xafdcc232ce53ULL,
+  0x1fe0bb59cc8aULL, 0x61e42563fdffULL, 0xe3e89a2dae60ULL, 0x9dec04179f15ULL,
+  0xfaf0f9b10843ULL, 0x84f4678b3936ULL, 0x06f8d8c56aa9ULL, 0x78fc46ff5bdcULL,
+  0xf61d5426dc0cULL, 0x8819ca1ced79ULL, 0x0a157552bee6ULL, 0x7411eb688f93ULL,
+  0x130d16ce18c5ULL, 0x6d0988f429b0ULL, 0xef0537ba7a2fULL, 0x9101a9804b5aULL,
+  0x213dd0eb4983ULL, 0x5f394ed178f6ULL, 0xdd35f19f2b69ULL, 0xa3316fa51a1cULL,
+  0xc42d92038d4aULL, 0xba290c39bc3fULL, 0x3825b377efa0ULL, 0x46212d4dded5ULL,
+  0x455d41a1eb0fULL, 0x3b59df9bda7aULL, 0xb95560d589e5ULL, 0xc751feefb890ULL,
+  0xa04d03492fc6ULL, 0xde499d731eb3ULL, 0x5c45223d4d2cULL, 0x2241bc077c59ULL,
+  0x927dc56c7e80ULL, 0xec795b564ff5ULL, 0x6e75e4181c6aULL, 0x10717a222d1fULL,
+  0x776d8784ba49ULL, 0x096919be8b3cULL, 0x8b65a6f0d8a3ULL, 0xf56138cae9d6ULL,
+  0x8d9d7e35b20aULL, 0xf399e00f837fULL, 0x71955f41d0e0ULL, 0x0f91c17be195ULL,
+  0x688d3cdd76c3ULL, 0x1689a2e747b6ULL, 0x94851da91429ULL, 0xea818393255cULL,
+  0x5abdfaf82785ULL, 0x24b964c216f0ULL, 0xa6b5db8c456fULL, 0xd8b145b6741aULL,
+  0xbfadb810e34cULL, 0xc1a9262ad239ULL, 0x43a5996481a6ULL, 0x3da1075eb0d3ULL,
+  0x3edd6bb28509ULL, 0x40d9f588b47cULL, 0xc2d54ac6e7e3ULL, 0xbcd1d4fcd696ULL,
+  0xdbcd295a41c0ULL, 0xa5c9b76070b5ULL, 0x27c5082e232aULL, 0x59c19614125fULL,
+  0xe9fdef7f1086ULL, 0x97f9714521f3ULL, 0x15f5ce0b726cULL, 0x6bf150314319ULL,
+  0x0cedad97d44fULL, 0x72e933ade53aULL, 0xf0e58ce3b6a5ULL, 0x8ee112d987d0ULL,
+  0xf13aa84ca518ULL, 0x8f3e3676946dULL, 0x0d328938c7f2ULL, 0x73361702f687ULL,
+  0x142aeaa461d1ULL, 0x6a2e749e50a4ULL, 0xe822cbd0033bULL, 0x962655ea324eULL,
+  0x261a2c813097ULL, 0x581eb2bb01e2ULL, 0xda120df5527dULL, 0xa41693cf6308ULL,
+  0xc30a6e69f45eULL, 0xbd0ef053c52bULL, 0x3f024f1d96b4ULL, 0x4106d127a7c1ULL,
+  0x427abdcb921bULL, 0x3c7e23f1a36eULL, 0xbe729cbff0f1ULL, 0xc0760285c184ULL,
+  0xa76aff2356d2ULL, 0xd96e611967a7ULL, 0x5b62de573438ULL, 0x2566406d054dULL,
+  0x955a39060794ULL, 0xeb5ea73c36e1ULL, 0x69521872657eULL, 0x17568648540bULL,
+  0x704a7beec35dULL, 0x0e4ee5d4f228ULL, 0x8c425a9aa1b7ULL, 0xf246c4a090c2ULL,
+  0x8aba825fcb1eULL, 0xf4be1c65fa6bULL, 0x76b2a32ba9f4ULL, 0x08b63d119881ULL,
+  0x6faac0b70fd7ULL, 0x11ae5e8d3ea2ULL, 0x93a2e1c36d3dULL, 0xeda67ff95c48ULL,
+  0x5d9a06925e91ULL, 0x239e98a86fe4ULL, 0xa19227e63c7bULL, 0xdf96b9dc0d0eULL,
+  0xb88a447a9a58ULL, 0xc68eda40ab2dULL, 0x4482650ef8b2ULL, 0x3a86fb34c9c7ULL,
+  0x39fa97d8fc1dULL, 0x47fe09e2cd68ULL, 0xc5f2b6ac9ef7ULL, 0xbbf62896af82ULL,
+  0xdcead53038d4ULL, 0xa2ee4b0a09a1ULL, 0x20e2f4445a3eULL, 0x5ee66a7e6b4bULL,
+  0xeeda13156992ULL, 0x90de8d2f58e7ULL, 0x12d232610b78ULL, 0x6cd6ac5b3a0dULL,
+  0x0bca51fdad5bULL, 0x75cecfc79c2eULL, 0xf7c27089cfb1ULL, 0x89c6eeb3fec4ULL,
+  0x0727fc6a7914ULL, 0x792362504861ULL, 0xfb2fdd1e1bfeULL, 0x852b43242a8bULL,
+  0xe237be82bdddULL, 0x9c3320b88ca8ULL, 0x1e3f9ff6df37ULL, 0x603b01ccee42ULL,
+  0xd00778a7ec9bULL, 0xae03e69dddeeULL, 0x2c0f59d38e71ULL, 0x520bc7e9bf04ULL,
+  0x35173a4f2852ULL, 0x4b13a4751927ULL, 0xc91f1b3b4ab8ULL, 0xb71b85017bcdULL,
+  0xb467e9ed4e17ULL, 0xca6377d77f62ULL, 0x486fc8992cfdULL, 0x366b56a31d88ULL,
+  0x5177ab058adeULL, 0x2f73353fbbabULL, 0xad7f8a71e834ULL, 0xd37b144bd941ULL,
+  0x63476d20db98ULL, 0x1d43f31aeaedULL, 0x9f4f4c54b972ULL, 0xe14bd26e8807ULL,
+  0x86572fc81f51ULL, 0xf853b1f22e24ULL, 0x7a5f0ebc7dbbULL, 0x045b90864cceULL,
+  0x7ca7d6791712ULL, 0x02a348432667ULL, 0x80aff70d75f8ULL, 0xfeab6937448dULL,
+  0x99b79491d3dbULL, 0xe7b30aabe2aeULL, 0x65bfb5e5b131ULL, 0x1bbb2bdf8044ULL,
+  0xab8752b4829dULL, 0xd583cc8eb3e8ULL, 0x578f73c0e077ULL, 0x298bedfad102ULL,
+  0x4e97105c4654ULL, 0x30938e667721ULL, 0xb29f312824beULL, 0xcc9baf1215cbULL,
+  0xcfe7c3fe2011ULL, 0xb1e35dc41164ULL, 0x33efe28a42fbULL, 0x4deb7cb0738eULL,
+  0x2af78116e4d8ULL, 0x54f31f2cd5adULL, 0xd6ffa0628632ULL, 0xa8fb3e58b747ULL,
+  0x18c74733b59eULL, 0x66c3d90984ebULL, 0xe4cf6647d774ULL, 0x9acbf87de601ULL,
+  0xfdd705db7157ULL, 0x83d39be14022ULL, 0x01df24af13bdULL, 0x7fdbba9522c8ULL
+};
+#else
+static uint64_t parityTable[256];
+#endif
+#endif
 
 //int DEBUG = FALSE;
 
+#if NPAR != 6
 static void
 compute_genpoly (int nbytes, int genpoly[]);
+#endif
+#if NPAR != 6 && NPAR <= 8
+static void
+compute_parity_table (void);
+#endif
 
 /* Initialize lookup tables, polynomials, etc. */
 void
@@ -49,8 +130,20 @@ initialize_ecc ()
   /* Initialize the galois field arithmetic tables */
     init_galois_tables();
 
+#if NPAR != 6
     /* Compute the encoder generator polynomial */
     compute_genpoly(NPAR, genPoly);
+#endif
+#if NPAR != 6 && NPAR <= 8
+    compute_parity_table();
+#endif
+}
+
+/* Clear a working state before first use */
+void
+rs_init_state (rs_state *st)
+{
+  memset(st, 0, sizeof(*st));
 }
 
 void
@@ -62,36 +155,36 @@ zero_fill_from (unsigned char buf[], int from, int to)
 
 /* debugging routines */
 void
-print_parity (void)
+print_parity (const rs_state *st)
 {
   int i;
   printf("Parity Bytes: ");
   for (i = 0; i < NPAR; i++)
-    printf("[%d]:%x, ",i,pBytes[i]);
+    printf("[%d]:%x, ",i,st->pBytes[i]);
   printf("\n");
 }
 
 
 void
-print_syndrome (void)
+print_syndrome (const rs_state *st)
 {
   int i;
   printf("Syndrome Bytes: ");
   for (i = 0; i < NPAR; i++)
-    printf("[%d]:%x, ",i,synBytes[i]);
+    printf("[%d]:%x, ",i,st->synBytes[i]);
   printf("\n");
 }
 
 /* Append the parity bytes onto the end of the message */
 void
-build_codeword (unsigned char msg[], int nbytes, unsigned char dst[])
+build_codeword (const rs_state *st, unsigned char msg[], int nbytes, unsigned char dst[])
 {
   int i;
 
   for (i = 0; i < nbytes; i++) dst[i] = msg[i];
 
   for (i = 0; i < NPAR; i++) {
-    dst[i+nbytes] = pBytes[NPAR-1-i];
+    dst[i+nbytes] = st->pBytes[NPAR-1-i];
   }
 }
 
@@ -99,11 +192,11 @@ build_codeword (unsigned char msg[], int nbytes, unsigned char dst[])
  * Reed Solomon Decoder
  *
  * Computes the syndrome of a codeword. Puts the results
- * into the synBytes[] array.
+ * into st->synBytes[].
  */
 
 void
-decode_data(unsigned char data[], int nbytes)
+decode_data(rs_state *st, unsigned char data[], int nbytes)
 {
   int i, j, sum;
   for (j = 0; j < NPAR;  j++) {
@@ -111,18 +204,18 @@ decode_data(unsigned char data[], int nbytes)
     for (i = 0; i < nbytes; i++) {
       sum = data[i] ^ gmult(gexp[j+1], sum);
     }
-    synBytes[j]  = sum;
+    st->synBytes[j]  = sum;
   }
 }
 
 
 /* Check if the syndrome is zero */
 int
-check_syndrome (void)
+check_syndrome (const rs_state *st)
 {
  int i, nz = 0;
  for (i =0 ; i < NPAR; i++) {
-  if (synBytes[i] != 0) {
+  if (st->synBytes[i] != 0) {
       nz = 1;
       break;
   }
@@ -132,17 +225,18 @@ check_syndrome (void)
 
 
 void
-debug_check_syndrome (void)
+debug_check_syndrome (const rs_state *st)
 {
   int i;
 
   for (i = 0; i < 3; i++) {
     printf(" inv log S[%d]/S[%d] = %d\n", i, i+1,
-	   glog[gmult(synBytes[i], ginv(synBytes[i+1]))]);
+	   glog[gmult(st->synBytes[i], ginv(st->synBytes[i+1]))]);
   }
 }
 
 
+#if NPAR != 6
 /* Create a generator polynomial for an n byte RS code.
  * The coefficients are returned in the genPoly arg.
  * Make sure that the genPoly array which is passed in is
@@ -168,18 +262,47 @@ compute_genpoly (int nbytes, int genpoly[])
     copy_poly(tp1, genpoly);
   }
 }
+#endif
+
+#if NPAR != 6 && NPAR <= 8
+static void
+compute_parity_table (void)
+{
+  int fb, j;
+
+  for (fb = 0; fb < 256; fb++) {
+    parityTable[fb] = 0;
+    for (j = 0; j < NPAR; j++)
+      parityTable[fb] |= (uint64_t)gmult(genPoly[j], fb) << (8*j);
+  }
+}
+#endif
 
 /* Simulate a LFSR with generator polynomial for n byte RS code.
  * Pass in a pointer to the data array, and amount of data.
  *
- * The parity bytes are deposited into pBytes[], and the whole message
+ * The parity bytes are deposited into st->pBytes[], and the whole message
  * and parity are copied to dest to make a codeword.
  *
  */
 
 void
-encode_data (unsigned char msg[], int nbytes, unsigned char dst[])
+encode_data (rs_state *st, unsigned char msg[], int nbytes, unsigned char dst[])
 {
+#if NPAR <= 8
+  /* LFSR[j] lives in byte j of the register, the top byte is the feedback tap */
+  int i;
+  uint64_t lfsr = 0;
+  uint8_t dbyte;
+
+  for (i = 0; i < nbytes; i++) {
+    dbyte = msg[i] ^ (uint8_t)(lfsr >> (8*(NPAR-1)));
+    lfsr = (lfsr << 8) ^ parityTable[dbyte];
+  }
+
+  for (i = 0; i < NPAR; i++)
+    st->pBytes[i] = (lfsr >> (8*i)) & 0xFF;
+#else
   int i, LFSR[NPAR+1],dbyte, j;
 
   for(i=0; i < NPAR+1; i++) LFSR[i]=0;
@@ -193,7 +316,8 @@ encode_data (unsigned char msg[], int nbytes, unsigned char dst[])
   }
 
   for (i = 0; i < NPAR; i++)
-    pBytes[i] = LFSR[i];
+    st->pBytes[i] = LFSR[i];
+#endif
 
-  build_codeword(msg, nbytes, dst);
+  build_codeword(st, msg, nbytes, dst);
 }
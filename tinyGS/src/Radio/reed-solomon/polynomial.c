@@ -1,16 +1,12 @@
 #include "polynomial.h"
 
-polynomial_t_rs polynomial_create(unsigned int order) {
+polynomial_t_rs polynomial_create(rs_arena_t *arena, unsigned int order) {
 	polynomial_t_rs polynomial;
-    polynomial.coeff = malloc(sizeof(field_element_t) * (order + 1));
+    polynomial.coeff = rs_arena_alloc(arena, sizeof(field_element_t) * (order + 1));
     polynomial.order = order;
     return polynomial;
 }
 
-void polynomial_destroy(polynomial_t_rs polynomial) {
-    free(polynomial.coeff);
-}
-
 // if you want a full multiplication, then make res.order = l.order + r.order
 // but if you just care about a lower order, e.g. mul mod x^i, then you can select
 //    fewer coefficients
@@ -209,47 +205,3 @@ polynomial_t_rs polynomial_init_from_roots(field_t field, unsigned int nroots, f
 
     return poly;
 }
-
-polynomial_t_rs polynomial_create_from_roots(field_t field, unsigned int nroots, field_element_t *roots) {
-	polynomial_t_rs poly = polynomial_create(nroots);
-    unsigned int order = nroots;
-    polynomial_t_rs l;
-    l.order = 1;
-    l.coeff = calloc(2, sizeof(field_element_t));
-
-    polynomial_t_rs r[2];
-    // we'll keep two temporary stores of rightside polynomial
-    // each time through the loop, we take the previous result and use it as new rightside
-    // swap back and forth (prevents the need for a copy)
-    r[0].coeff = calloc(order + 1, sizeof(field_element_t));
-    r[1].coeff = calloc(order + 1, sizeof(field_element_t));
-    unsigned int rcoeffres = 0;
-
-    // initialize the result with x + roots[0]
-    r[rcoeffres].coeff[0] = roots[0];
-    r[rcoeffres].coeff[1] = 1;
-    r[rcoeffres].order = 1;
-
-    // initialize lcoeff[1] with x
-    // we'll fill in the 0th order term in each loop iter
-    l.coeff[1] = 1;
-
-    // loop through, using previous run's result as the new right hand side
-    // this allows us to multiply one group at a time
-    for (unsigned int i = 1; i < nroots; i++) {
-        l.coeff[0] = roots[i];
-        unsigned int nextrcoeff = rcoeffres;
-        rcoeffres = (rcoeffres + 1) % 2;
-        r[rcoeffres].order = i + 1;
-        polynomial_mul(field, l, r[nextrcoeff], r[rcoeffres]);
-    }
-
-    memcpy(poly.coeff, r[rcoeffres].coeff, (order + 1) * sizeof(field_element_t));
-    poly.order = order;
-
-    free(l.coeff);
-    free(r[0].coeff);
-    free(r[1].coeff);
-
-    return poly;
-}
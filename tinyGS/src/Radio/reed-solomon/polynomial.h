@@ -1,8 +1,24 @@
 #include "../correct/reed-solomon.h"
 #include "field.h"
 
-polynomial_t_rs polynomial_create(unsigned int order);
-void polynomial_destroy(polynomial_t_rs polynomial);
+// bump allocator over the workspace of one rs instance
+// with a NULL base it only measures, which is how the workspace size is found
+typedef struct {
+    uint8_t *base;
+    size_t size;
+    size_t used;
+} rs_arena_t;
+
+static inline void *rs_arena_alloc(rs_arena_t *arena, size_t size) {
+    size_t start = (arena->used + 7) & ~(size_t)7;
+    arena->used = start + size;
+    if (!arena->base || arena->used > arena->size) {
+        return NULL;
+    }
+    return arena->base + start;
+}
+
+polynomial_t_rs polynomial_create(rs_arena_t *arena, unsigned int order);
 void polynomial_mul(field_t field, polynomial_t_rs l, polynomial_t_rs r, polynomial_t_rs res);
 void polynomial_mod(field_t field, polynomial_t_rs dividend, polynomial_t_rs divisor, polynomial_t_rs mod);
 void polynomial_formal_derivative(field_t field, polynomial_t_rs poly, polynomial_t_rs der);
@@ -11,4 +27,3 @@ field_element_t polynomial_eval_lut(field_t field, polynomial_t_rs poly, const f
 field_element_t polynomial_eval_log_lut(field_t field, polynomial_t_rs poly_log, const field_logarithm_t *val_exp);
 void polynomial_build_exp_lut(field_t field, field_element_t val, unsigned int order, field_logarithm_t *val_exp);
 polynomial_t_rs polynomial_init_from_roots(field_t field, unsigned int nroots, field_element_t *roots, polynomial_t_rs poly, polynomial_t_rs *scratch);
-polynomial_t_rs polynomial_create_from_roots(field_t field, unsigned int nroots, field_element_t *roots);
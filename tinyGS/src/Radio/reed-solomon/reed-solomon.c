@@ -1,20 +1,115 @@
 #include "reed-solomon.h"
 
-// coeff must be of size nroots + 1
-// e.g. 2 roots (x + alpha)(x + alpha^2) yields a poly with 3 terms x^2 + g0*x + g1
-static polynomial_t_rs reed_solomon_build_generator(field_t field, unsigned int nroots, field_element_t first_consecutive_root, unsigned int root_gap, polynomial_t_rs generator, field_element_t *roots) {
-    // generator has order 2*t
-    // of form (x + alpha^1)(x + alpha^2)...(x - alpha^2*t)
-    for (unsigned int i = 0; i < nroots; i++) {
-        roots[i] = field.exp[(root_gap * (i + first_consecutive_root)) % 255];
+static bool reed_solomon_tables_match(const correct_reed_solomon_tables *tables, field_operation_t primitive_polynomial,
+                                      field_logarithm_t first_consecutive_root, field_logarithm_t generator_root_gap,
+                                      size_t num_roots) {
+    return tables->primitive_polynomial == primitive_polynomial &&
+           tables->first_consecutive_root == first_consecutive_root &&
+           tables->generator_root_gap == generator_root_gap && tables->num_roots == num_roots;
+}
+
+// carve every buffer the encoder and decoder will ever use out of the arena
+// the big tables come from tables instead when given
+// with a measuring arena only arena->used is meaningful afterwards
+static void reed_solomon_layout(correct_reed_solomon *rs, rs_arena_t *arena, const correct_reed_solomon_tables *tables) {
+    size_t n = rs->min_distance;
+
+    if (tables) {
+        rs->field.exp = tables->exp;
+        rs->field.log = tables->log;
+        rs->generator_root_mul = tables->generator_root_mul;
+        rs->element_exp = tables->element_exp;
+    } else {
+        rs->field.exp = rs_arena_alloc(arena, 512 * sizeof(field_element_t));
+        rs->field.log = rs_arena_alloc(arena, 256 * sizeof(field_logarithm_t));
+        // total memory usage is min_distance * 256 bytes each e.g. 32 * 256 = 8k
+        rs->generator_root_mul = rs_arena_alloc(arena, n * 256 * sizeof(field_element_t));
+        rs->element_exp = rs_arena_alloc(arena, 256 * n * sizeof(field_logarithm_t));
     }
-    return polynomial_create_from_roots(field, nroots, roots);
+
+    rs->generator_roots = rs_arena_alloc(arena, n * sizeof(field_element_t));
+    rs->generator = polynomial_create(arena, n);
+
+    rs->encoded_polynomial = polynomial_create(arena, rs->block_length - 1);
+    rs->encoded_remainder = polynomial_create(arena, rs->block_length - 1);
+
+    rs->syndromes = rs_arena_alloc(arena, n * sizeof(field_element_t));
+    rs->modified_syndromes = rs_arena_alloc(arena, 2 * n * sizeof(field_element_t));
+    rs->received_polynomial = polynomial_create(arena, rs->block_length - 1);
+    rs->error_locator = polynomial_create(arena, n);
+    rs->error_locator_log = polynomial_create(arena, n);
+    rs->erasure_locator = polynomial_create(arena, n);
+    rs->error_roots = rs_arena_alloc(arena, 2 * n * sizeof(field_element_t));
+    rs->error_vals = rs_arena_alloc(arena, n * sizeof(field_element_t));
+    rs->error_locations = rs_arena_alloc(arena, n * sizeof(field_logarithm_t));
+
+    rs->last_error_locator = polynomial_create(arena, n);
+    rs->error_evaluator = polynomial_create(arena, n - 1);
+    rs->error_locator_derivative = polynomial_create(arena, n - 1);
+    rs->init_from_roots_scratch[0] = polynomial_create(arena, n);
+    rs->init_from_roots_scratch[1] = polynomial_create(arena, n);
+
+    rs->syndrome_copy = rs_arena_alloc(arena, n * sizeof(field_element_t));
+    // error locator times erasure locator, each can reach min_distance
+    rs->erasure_error_locator = polynomial_create(arena, 2 * n);
 }
 
-correct_reed_solomon *correct_reed_solomon_create(field_operation_t primitive_polynomial, field_logarithm_t first_consecutive_root, field_logarithm_t generator_root_gap, size_t num_roots) {
-    correct_reed_solomon *rs = calloc(1, sizeof(correct_reed_solomon));
-    rs->field = field_create(primitive_polynomial);
+// fill the decoder tables that live in the workspace, needs the field and generator roots
+static void reed_solomon_build_tables(correct_reed_solomon *rs) {
+    // multiplication table of every generator root, so a syndrome costs one lookup per byte
+    field_element_t *generator_root_mul = (field_element_t *)rs->generator_root_mul;
+    for (unsigned int i = 0; i < rs->min_distance; i++) {
+        field_logarithm_t root_log = rs->field.log[rs->generator_roots[i]];
+        field_element_t *mul = generator_root_mul + 256 * i;
+        mul[0] = 0;
+        for (unsigned int x = 1; x < 256; x++) {
+            mul[x] = field_mul_log_element(rs->field, rs->field.log[x], root_log);
+        }
+    }
+
+    // calculate and store the first min_distance powers of every element in the field
+    // we would have to do this for chien search anyway, and its size is only 256 * min_distance bytes
+    // for min_distance = 32 this is 8k of memory, a pittance for the speedup we receive in exchange
+    // we also get to reuse this work during error value calculation
+    field_logarithm_t *element_exp = (field_logarithm_t *)rs->element_exp;
+    for (field_operation_t i = 0; i < 256; i++) {
+        polynomial_build_exp_lut(rs->field, i, rs->min_distance - 1, element_exp + i * rs->min_distance);
+    }
+}
+
+size_t correct_reed_solomon_workspace_size(size_t num_roots, const correct_reed_solomon_tables *tables) {
+    correct_reed_solomon measured;
+    measured.block_length = 255;
+    measured.min_distance = num_roots;
+
+    rs_arena_t arena = {NULL, 0, 0};
+    rs_arena_alloc(&arena, sizeof(correct_reed_solomon));
+    reed_solomon_layout(&measured, &arena, tables);
+    // slack to align an arbitrary workspace pointer
+    return arena.used + 7;
+}
+
+correct_reed_solomon *correct_reed_solomon_create_in(void *workspace, size_t workspace_size,
+                                                     field_operation_t primitive_polynomial,
+                                                     field_logarithm_t first_consecutive_root,
+                                                     field_logarithm_t generator_root_gap, size_t num_roots,
+                                                     const correct_reed_solomon_tables *tables) {
+    if (!workspace || !num_roots || num_roots >= 255) {
+        return NULL;
+    }
+    if (tables && !reed_solomon_tables_match(tables, primitive_polynomial, first_consecutive_root,
+                                             generator_root_gap, num_roots)) {
+        return NULL;
+    }
+    if (workspace_size < correct_reed_solomon_workspace_size(num_roots, tables)) {
+        return NULL;
+    }
 
+    size_t align = (8 - ((uintptr_t)workspace & 7)) & 7;
+    rs_arena_t arena = {(uint8_t *)workspace + align, workspace_size - align, 0};
+    memset(arena.base, 0, arena.size);
+
+    correct_reed_solomon *rs = rs_arena_alloc(&arena, sizeof(correct_reed_solomon));
     rs->block_length = 255;
     rs->min_distance = num_roots;
     rs->message_length = rs->block_length - rs->min_distance;
@@ -22,49 +117,48 @@ correct_reed_solomon *correct_reed_solomon_create(field_operation_t primitive_po
     rs->first_consecutive_root = first_consecutive_root;
     rs->generator_root_gap = generator_root_gap;
 
-    rs->generator_roots = malloc(rs->min_distance * sizeof(field_element_t));
+    reed_solomon_layout(rs, &arena, tables);
 
-    rs->generator = reed_solomon_build_generator(rs->field, rs->min_distance, rs->first_consecutive_root, rs->generator_root_gap, rs->generator, rs->generator_roots);
+    if (!tables) {
+        // the exp/log tables are needed for the roots, the rest needs the roots
+        rs->field = field_create(primitive_polynomial, (field_element_t *)rs->field.exp,
+                                 (field_logarithm_t *)rs->field.log);
+    }
 
-    rs->encoded_polynomial = polynomial_create(rs->block_length - 1);
-    rs->encoded_remainder = polynomial_create(rs->block_length - 1);
+    // generator has order 2*t
+    // of form (x + alpha^1)(x + alpha^2)...(x - alpha^2*t)
+    for (unsigned int i = 0; i < rs->min_distance; i++) {
+        rs->generator_roots[i] = rs->field.exp[(generator_root_gap * (i + first_consecutive_root)) % 255];
+    }
+    rs->generator = polynomial_init_from_roots(rs->field, rs->min_distance, rs->generator_roots, rs->generator,
+                                               rs->init_from_roots_scratch);
 
-    rs->has_init_decode = false;
+    if (!tables) {
+        reed_solomon_build_tables(rs);
+    }
 
     return rs;
 }
 
+correct_reed_solomon *correct_reed_solomon_create(field_operation_t primitive_polynomial, field_logarithm_t first_consecutive_root, field_logarithm_t generator_root_gap, size_t num_roots) {
+    // one allocation for everything, nothing more is allocated while encoding or decoding
+    size_t size = correct_reed_solomon_workspace_size(num_roots, NULL);
+    void *workspace = malloc(size);
+    correct_reed_solomon *rs = correct_reed_solomon_create_in(workspace, size, primitive_polynomial,
+                                                              first_consecutive_root, generator_root_gap, num_roots, NULL);
+    if (!rs) {
+        free(workspace);
+        return NULL;
+    }
+    rs->heap_workspace = workspace;
+    return rs;
+}
+
 void correct_reed_solomon_destroy(correct_reed_solomon *rs) {
-    field_destroy(rs->field);
-    polynomial_destroy(rs->generator);
-    free(rs->generator_roots);
-    polynomial_destroy(rs->encoded_polynomial);
-    polynomial_destroy(rs->encoded_remainder);
-    if (rs->has_init_decode) {
-        free(rs->syndromes);
-        free(rs->modified_syndromes);
-        polynomial_destroy(rs->received_polynomial);
-        polynomial_destroy(rs->error_locator);
-        polynomial_destroy(rs->error_locator_log);
-        polynomial_destroy(rs->erasure_locator);
-        free(rs->error_roots);
-        free(rs->error_vals);
-        free(rs->error_locations);
-        polynomial_destroy(rs->last_error_locator);
-        polynomial_destroy(rs->error_evaluator);
-        polynomial_destroy(rs->error_locator_derivative);
-        for (unsigned int i = 0; i < rs->min_distance; i++) {
-            free(rs->generator_root_exp[i]);
-        }
-        free(rs->generator_root_exp);
-        for (field_operation_t i = 0; i < 256; i++) {
-            free(rs->element_exp[i]);
-        }
-        free(rs->element_exp);
-        polynomial_destroy(rs->init_from_roots_scratch[0]);
-        polynomial_destroy(rs->init_from_roots_scratch[1]);
+    // instances built in a caller's workspace own nothing
+    if (rs) {
+        free(rs->heap_workspace);
     }
-    free(rs);
 }
 
 void correct_reed_solomon_debug_print(correct_reed_solomon *rs) {
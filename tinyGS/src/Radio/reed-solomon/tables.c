@@ -0,0 +1,271 @@
+#include "reed-solomon.h"
+
+// precomputed tables for the codes we decode most, so they can live in flash
+// generated from correct_reed_solomon_create_in with tables = NULL
+
+// alpha^i, twice round so sums of two logs need no modulo
+static const uint8_t exp_8_4_3_2_0[512] = {
+    0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26,
+    0x4c, 0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0,
+    0x9d, 0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23,
+    0x46, 0x8c, 0x05, 0x0a, 0x14, 0x28, 0x50, 0xa0, 0x5d, 0xba, 0x69, 0xd2, 0xb9, 0x6f, 0xde, 0xa1,
+    0x5f, 0xbe, 0x61, 0xc2, 0x99, 0x2f, 0x5e, 0xbc, 0x65, 0xca, 0x89, 0x0f, 0x1e, 0x3c, 0x78, 0xf0,
+    0xfd, 0xe7, 0xd3, 0xbb, 0x6b, 0xd6, 0xb1, 0x7f, 0xfe, 0xe1, 0xdf, 0xa3, 0x5b, 0xb6, 0x71, 0xe2,
+    0xd9, 0xaf, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0d, 0x1a, 0x34, 0x68, 0xd0, 0xbd, 0x67, 0xce,
+    0x81, 0x1f, 0x3e, 0x7c, 0xf8, 0xed, 0xc7, 0x93, 0x3b, 0x76, 0xec, 0xc5, 0x97, 0x33, 0x66, 0xcc,
+    0x85, 0x17, 0x2e, 0x5c, 0xb8, 0x6d, 0xda, 0xa9, 0x4f, 0x9e, 0x21, 0x42, 0x84, 0x15, 0x2a, 0x54,
+    0xa8, 0x4d, 0x9a, 0x29, 0x52, 0xa4, 0x55, 0xaa, 0x49, 0x92, 0x39, 0x72, 0xe4, 0xd5, 0xb7, 0x73,
+    0xe6, 0xd1, 0xbf, 0x63, 0xc6, 0x91, 0x3f, 0x7e, 0xfc, 0xe5, 0xd7, 0xb3, 0x7b, 0xf6, 0xf1, 0xff,
+    0xe3, 0xdb, 0xab, 0x4b, 0x96, 0x31, 0x62, 0xc4, 0x95, 0x37, 0x6e, 0xdc, 0xa5, 0x57, 0xae, 0x41,
+    0x82, 0x19, 0x32, 0x64, 0xc8, 0x8d, 0x07, 0x0e, 0x1c, 0x38, 0x70, 0xe0, 0xdd, 0xa7, 0x53, 0xa6,
+    0x51, 0xa2, 0x59, 0xb2, 0x79, 0xf2, 0xf9, 0xef, 0xc3, 0x9b, 0x2b, 0x56, 0xac, 0x45, 0x8a, 0x09,
+    0x12, 0x24, 0x48, 0x90, 0x3d, 0x7a, 0xf4, 0xf5, 0xf7, 0xf3, 0xfb, 0xeb, 0xcb, 0x8b, 0x0b, 0x16,
+    0x2c, 0x58, 0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e, 0x01,
+    0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1d, 0x3a, 0x74, 0xe8, 0xcd, 0x87, 0x13, 0x26, 0x4c,
+    0x98, 0x2d, 0x5a, 0xb4, 0x75, 0xea, 0xc9, 0x8f, 0x03, 0x06, 0x0c, 0x18, 0x30, 0x60, 0xc0, 0x9d,
+    0x27, 0x4e, 0x9c, 0x25, 0x4a, 0x94, 0x35, 0x6a, 0xd4, 0xb5, 0x77, 0xee, 0xc1, 0x9f, 0x23, 0x46,
+    0x8c, 0x05, 0x0a, 0x14, 0x28, 0x50, 0xa0, 0x5d, 0xba, 0x69, 0xd2, 0xb9, 0x6f, 0xde, 0xa1, 0x5f,
+    0xbe, 0x61, 0xc2, 0x99, 0x2f, 0x5e, 0xbc, 0x65, 0xca, 0x89, 0x0f, 0x1e, 0x3c, 0x78, 0xf0, 0xfd,
+    0xe7, 0xd3, 0xbb, 0x6b, 0xd6, 0xb1, 0x7f, 0xfe, 0xe1, 0xdf, 0xa3, 0x5b, 0xb6, 0x71, 0xe2, 0xd9,
+    0xaf, 0x43, 0x86, 0x11, 0x22, 0x44, 0x88, 0x0d, 0x1a, 0x34, 0x68, 0xd0, 0xbd, 0x67, 0xce, 0x81,
+    0x1f, 0x3e, 0x7c, 0xf8, 0xed, 0xc7, 0x93, 0x3b, 0x76, 0xec, 0xc5, 0x97, 0x33, 0x66, 0xcc, 0x85,
+    0x17, 0x2e, 0x5c, 0xb8, 0x6d, 0xda, 0xa9, 0x4f, 0x9e, 0x21, 0x42, 0x84, 0x15, 0x2a, 0x54, 0xa8,
+    0x4d, 0x9a, 0x29, 0x52, 0xa4, 0x55, 0xaa, 0x49, 0x92, 0x39, 0x72, 0xe4, 0xd5, 0xb7, 0x73, 0xe6,
+    0xd1, 0xbf, 0x63, 0xc6, 0x91, 0x3f, 0x7e, 0xfc, 0xe5, 0xd7, 0xb3, 0x7b, 0xf6, 0xf1, 0xff, 0xe3,
+    0xdb, 0xab, 0x4b, 0x96, 0x31, 0x62, 0xc4, 0x95, 0x37, 0x6e, 0xdc, 0xa5, 0x57, 0xae, 0x41, 0x82,
+    0x19, 0x32, 0x64, 0xc8, 0x8d, 0x07, 0x0e, 0x1c, 0x38, 0x70, 0xe0, 0xdd, 0xa7, 0x53, 0xa6, 0x51,
+    0xa2, 0x59, 0xb2, 0x79, 0xf2, 0xf9, 0xef, 0xc3, 0x9b, 0x2b, 0x56, 0xac, 0x45, 0x8a, 0x09, 0x12,
+    0x24, 0x48, 0x90, 0x3d, 0x7a, 0xf4, 0xf5, 0xf7, 0xf3, 0xfb, 0xeb, 0xcb, 0x8b, 0x0b, 0x16, 0x2c,
+    0x58, 0xb0, 0x7d, 0xfa, 0xe9, 0xcf, 0x83, 0x1b, 0x36, 0x6c, 0xd8, 0xad, 0x47, 0x8e, 0x01, 0x02
+};
+
+// log of every element, log(0) is unused
+static const uint8_t log_8_4_3_2_0[256] = {
+    0x00, 0xff, 0x01, 0x19, 0x02, 0x32, 0x1a, 0xc6, 0x03, 0xdf, 0x33, 0xee, 0x1b, 0x68, 0xc7, 0x4b,
+    0x04, 0x64, 0xe0, 0x0e, 0x34, 0x8d, 0xef, 0x81, 0x1c, 0xc1, 0x69, 0xf8, 0xc8, 0x08, 0x4c, 0x71,
+    0x05, 0x8a, 0x65, 0x2f, 0xe1, 0x24, 0x0f, 0x21, 0x35, 0x93, 0x8e, 0xda, 0xf0, 0x12, 0x82, 0x45,
+    0x1d, 0xb5, 0xc2, 0x7d, 0x6a, 0x27, 0xf9, 0xb9, 0xc9, 0x9a, 0x09, 0x78, 0x4d, 0xe4, 0x72, 0xa6,
+    0x06, 0xbf, 0x8b, 0x62, 0x66, 0xdd, 0x30, 0xfd, 0xe2, 0x98, 0x25, 0xb3, 0x10, 0x91, 0x22, 0x88,
+    0x36, 0xd0, 0x94, 0xce, 0x8f, 0x96, 0xdb, 0xbd, 0xf1, 0xd2, 0x13, 0x5c, 0x83, 0x38, 0x46, 0x40,
+    0x1e, 0x42, 0xb6, 0xa3, 0xc3, 0x48, 0x7e, 0x6e, 0x6b, 0x3a, 0x28, 0x54, 0xfa, 0x85, 0xba, 0x3d,
+    0xca, 0x5e, 0x9b, 0x9f, 0x0a, 0x15, 0x79, 0x2b, 0x4e, 0xd4, 0xe5, 0xac, 0x73, 0xf3, 0xa7, 0x57,
+    0x07, 0x70, 0xc0, 0xf7, 0x8c, 0x80, 0x63, 0x0d, 0x67, 0x4a, 0xde, 0xed, 0x31, 0xc5, 0xfe, 0x18,
+    0xe3, 0xa5, 0x99, 0x77, 0x26, 0xb8, 0xb4, 0x7c, 0x11, 0x44, 0x92, 0xd9, 0x23, 0x20, 0x89, 0x2e,
+    0x37, 0x3f, 0xd1, 0x5b, 0x95, 0xbc, 0xcf, 0xcd, 0x90, 0x87, 0x97, 0xb2, 0xdc, 0xfc, 0xbe, 0x61,
+    0xf2, 0x56, 0xd3, 0xab, 0x14, 0x2a, 0x5d, 0x9e, 0x84, 0x3c, 0x39, 0x53, 0x47, 0x6d, 0x41, 0xa2,
+    0x1f, 0x2d, 0x43, 0xd8, 0xb7, 0x7b, 0xa4, 0x76, 0xc4, 0x17, 0x49, 0xec, 0x7f, 0x0c, 0x6f, 0xf6,
+    0x6c, 0xa1, 0x3b, 0x52, 0x29, 0x9d, 0x55, 0xaa, 0xfb, 0x60, 0x86, 0xb1, 0xbb, 0xcc, 0x3e, 0x5a,
+    0xcb, 0x59, 0x5f, 0xb0, 0x9c, 0xa9, 0xa0, 0x51, 0x0b, 0xf5, 0x16, 0xeb, 0x7a, 0x75, 0x2c, 0xd7,
+    0x4f, 0xae, 0xd5, 0xe9, 0xe6, 0xe7, 0xad, 0xe8, 0x74, 0xd6, 0xf4, 0xea, 0xa8, 0x50, 0x58, 0xaf
+};
+
+// x * alpha^(i+1) for every x, one row of 256 per generator root
+static const uint8_t generator_root_mul_8_4_3_2_0_6[1536] = {
+    0x00, 0x02, 0x04, 0x06, 0x08, 0x0a, 0x0c, 0x0e, 0x10, 0x12, 0x14, 0x16, 0x18, 0x1a, 0x1c, 0x1e,
+    0x20, 0x22, 0x24, 0x26, 0x28, 0x2a, 0x2c, 0x2e, 0x30, 0x32, 0x34, 0x36, 0x38, 0x3a, 0x3c, 0x3e,
+    0x40, 0x42, 0x44, 0x46, 0x48, 0x4a, 0x4c, 0x4e, 0x50, 0x52, 0x54, 0x56, 0x58, 0x5a, 0x5c, 0x5e,
+    0x60, 0x62, 0x64, 0x66, 0x68, 0x6a, 0x6c, 0x6e, 0x70, 0x72, 0x74, 0x76, 0x78, 0x7a, 0x7c, 0x7e,
+    0x80, 0x82, 0x84, 0x86, 0x88, 0x8a, 0x8c, 0x8e, 0x90, 0x92, 0x94, 0x96, 0x98, 0x9a, 0x9c, 0x9e,
+    0xa0, 0xa2, 0xa4, 0xa6, 0xa8, 0xaa, 0xac, 0xae, 0xb0, 0xb2, 0xb4, 0xb6, 0xb8, 0xba, 0xbc, 0xbe,
+    0xc0, 0xc2, 0xc4, 0xc6, 0xc8, 0xca, 0xcc, 0xce, 0xd0, 0xd2, 0xd4, 0xd6, 0xd8, 0xda, 0xdc, 0xde,
+    0xe0, 0xe2, 0xe4, 0xe6, 0xe8, 0xea, 0xec, 0xee, 0xf0, 0xf2, 0xf4, 0xf6, 0xf8, 0xfa, 0xfc, 0xfe,
+    0x1d, 0x1f, 0x19, 0x1b, 0x15, 0x17, 0x11, 0x13, 0x0d, 0x0f, 0x09, 0x0b, 0x05, 0x07, 0x01, 0x03,
+    0x3d, 0x3f, 0x39, 0x3b, 0x35, 0x37, 0x31, 0x33, 0x2d, 0x2f, 0x29, 0x2b, 0x25, 0x27, 0x21, 0x23,
+    0x5d, 0x5f, 0x59, 0x5b, 0x55, 0x57, 0x51, 0x53, 0x4d, 0x4f, 0x49, 0x4b, 0x45, 0x47, 0x41, 0x43,
+    0x7d, 0x7f, 0x79, 0x7b, 0x75, 0x77, 0x71, 0x73, 0x6d, 0x6f, 0x69, 0x6b, 0x65, 0x67, 0x61, 0x63,
+    0x9d, 0x9f, 0x99, 0x9b, 0x95, 0x97, 0x91, 0x93, 0x8d, 0x8f, 0x89, 0x8b, 0x85, 0x87, 0x81, 0x83,
+    0xbd, 0xbf, 0xb9, 0xbb, 0xb5, 0xb7, 0xb1, 0xb3, 0xad, 0xaf, 0xa9, 0xab, 0xa5, 0xa7, 0xa1, 0xa3,
+    0xdd, 0xdf, 0xd9, 0xdb, 0xd5, 0xd7, 0xd1, 0xd3, 0xcd, 0xcf, 0xc9, 0xcb, 0xc5, 0xc7, 0xc1, 0xc3,
+    0xfd, 0xff, 0xf9, 0xfb, 0xf5, 0xf7, 0xf1, 0xf3, 0xed, 0xef, 0xe9, 0xeb, 0xe5, 0xe7, 0xe1, 0xe3,
+    0x00, 0x04, 0x08, 0x0c, 0x10, 0x14, 0x18, 0x1c, 0x20, 0x24, 0x28, 0x2c, 0x30, 0x34, 0x38, 0x3c,
+    0x40, 0x44, 0x48, 0x4c, 0x50, 0x54, 0x58, 0x5c, 0x60, 0x64, 0x68, 0x6c, 0x70, 0x74, 0x78, 0x7c,
+    0x80, 0x84, 0x88, 0x8c, 0x90, 0x94, 0x98, 0x9c, 0xa0, 0xa4, 0xa8, 0xac, 0xb0, 0xb4, 0xb8, 0xbc,
+    0xc0, 0xc4, 0xc8, 0xcc, 0xd0, 0xd4, 0xd8, 0xdc, 0xe0, 0xe4, 0xe8, 0xec, 0xf0, 0xf4, 0xf8, 0xfc,
+    0x1d, 0x19, 0x15, 0x11, 0x0d, 0x09, 0x05, 0x01, 0x3d, 0x39, 0x35, 0x31, 0x2d, 0x29, 0x25, 0x21,
+    0x5d, 0x59, 0x55, 0x51, 0x4d, 0x49, 0x45, 0x41, 0x7d, 0x79, 0x75, 0x71, 0x6d, 0x69, 0x65, 0x61,
+    0x9d, 0x99, 0x95, 0x91, 0x8d, 0x89, 0x85, 0x81, 0xbd, 0xb9, 0xb5, 0xb1, 0xad, 0xa9, 0xa5, 0xa1,
+    0xdd, 0xd9, 0xd5, 0xd1, 0xcd, 0xc9, 0xc5, 0xc1, 0xfd, 0xf9, 0xf5, 0xf1, 0xed, 0xe9, 0xe5, 0xe1,
+    0x3a, 0x3e, 0x32, 0x36, 0x2a, 0x2e, 0x22, 0x26, 0x1a, 0x1e, 0x12, 0x16, 0x0a, 0x0e, 0x02, 0x06,
+    0x7a, 0x7e, 0x72, 0x76, 0x6a, 0x6e, 0x62, 0x66, 0x5a, 0x5e, 0x52, 0x56, 0x4a, 0x4e, 0x42, 0x46,
+    0xba, 0xbe, 0xb2, 0xb6, 0xaa, 0xae, 0xa2, 0xa6, 0x9a, 0x9e, 0x92, 0x96, 0x8a, 0x8e, 0x82, 0x86,
+    0xfa, 0xfe, 0xf2, 0xf6, 0xea, 0xee, 0xe2, 0xe6, 0xda, 0xde, 0xd2, 0xd6, 0xca, 0xce, 0xc2, 0xc6,
+    0x27, 0x23, 0x2f, 0x2b, 0x37, 0x33, 0x3f, 0x3b, 0x07, 0x03, 0x0f, 0x0b, 0x17, 0x13, 0x1f, 0x1b,
+    0x67, 0x63, 0x6f, 0x6b, 0x77, 0x73, 0x7f, 0x7b, 0x47, 0x43, 0x4f, 0x4b, 0x57, 0x53, 0x5f, 0x5b,
+    0xa7, 0xa3, 0xaf, 0xab, 0xb7, 0xb3, 0xbf, 0xbb, 0x87, 0x83, 0x8f, 0x8b, 0x97, 0x93, 0x9f, 0x9b,
+    0xe7, 0xe3, 0xef, 0xeb, 0xf7, 0xf3, 0xff, 0xfb, 0xc7, 0xc3, 0xcf, 0xcb, 0xd7, 0xd3, 0xdf, 0xdb,
+    0x00, 0x08, 0x10, 0x18, 0x20, 0x28, 0x30, 0x38, 0x40, 0x48, 0x50, 0x58, 0x60, 0x68, 0x70, 0x78,
+    0x80, 0x88, 0x90, 0x98, 0xa0, 0xa8, 0xb0, 0xb8, 0xc0, 0xc8, 0xd0, 0xd8, 0xe0, 0xe8, 0xf0, 0xf8,
+    0x1d, 0x15, 0x0d, 0x05, 0x3d, 0x35, 0x2d, 0x25, 0x5d, 0x55, 0x4d, 0x45, 0x7d, 0x75, 0x6d, 0x65,
+    0x9d, 0x95, 0x8d, 0x85, 0xbd, 0xb5, 0xad, 0xa5, 0xdd, 0xd5, 0xcd, 0xc5, 0xfd, 0xf5, 0xed, 0xe5,
+    0x3a, 0x32, 0x2a, 0x22, 0x1a, 0x12, 0x0a, 0x02, 0x7a, 0x72, 0x6a, 0x62, 0x5a, 0x52, 0x4a, 0x42,
+    0xba, 0xb2, 0xaa, 0xa2, 0x9a, 0x92, 0x8a, 0x82, 0xfa, 0xf2, 0xea, 0xe2, 0xda, 0xd2, 0xca, 0xc2,
+    0x27, 0x2f, 0x37, 0x3f, 0x07, 0x0f, 0x17, 0x1f, 0x67, 0x6f, 0x77, 0x7f, 0x47, 0x4f, 0x57, 0x5f,
+    0xa7, 0xaf, 0xb7, 0xbf, 0x87, 0x8f, 0x97, 0x9f, 0xe7, 0xef, 0xf7, 0xff, 0xc7, 0xcf, 0xd7, 0xdf,
+    0x74, 0x7c, 0x64, 0x6c, 0x54, 0x5c, 0x44, 0x4c, 0x34, 0x3c, 0x24, 0x2c, 0x14, 0x1c, 0x04, 0x0c,
+    0xf4, 0xfc, 0xe4, 0xec, 0xd4, 0xdc, 0xc4, 0xcc, 0xb4, 0xbc, 0xa4, 0xac, 0x94, 0x9c, 0x84, 0x8c,
+    0x69, 0x61, 0x79, 0x71, 0x49, 0x41, 0x59, 0x51, 0x29, 0x21, 0x39, 0x31, 0x09, 0x01, 0x19, 0x11,
+    0xe9, 0xe1, 0xf9, 0xf1, 0xc9, 0xc1, 0xd9, 0xd1, 0xa9, 0xa1, 0xb9, 0xb1, 0x89, 0x81, 0x99, 0x91,
+    0x4e, 0x46, 0x5e, 0x56, 0x6e, 0x66, 0x7e, 0x76, 0x0e, 0x06, 0x1e, 0x16, 0x2e, 0x26, 0x3e, 0x36,
+    0xce, 0xc6, 0xde, 0xd6, 0xee, 0xe6, 0xfe, 0xf6, 0x8e, 0x86, 0x9e, 0x96, 0xae, 0xa6, 0xbe, 0xb6,
+    0x53, 0x5b, 0x43, 0x4b, 0x73, 0x7b, 0x63, 0x6b, 0x13, 0x1b, 0x03, 0x0b, 0x33, 0x3b, 0x23, 0x2b,
+    0xd3, 0xdb, 0xc3, 0xcb, 0xf3, 0xfb, 0xe3, 0xeb, 0x93, 0x9b, 0x83, 0x8b, 0xb3, 0xbb, 0xa3, 0xab,
+    0x00, 0x10, 0x20, 0x30, 0x40, 0x50, 0x60, 0x70, 0x80, 0x90, 0xa0, 0xb0, 0xc0, 0xd0, 0xe0, 0xf0,
+    0x1d, 0x0d, 0x3d, 0x2d, 0x5d, 0x4d, 0x7d, 0x6d, 0x9d, 0x8d, 0xbd, 0xad, 0xdd, 0xcd, 0xfd, 0xed,
+    0x3a, 0x2a, 0x1a, 0x0a, 0x7a, 0x6a, 0x5a, 0x4a, 0xba, 0xaa, 0x9a, 0x8a, 0xfa, 0xea, 0xda, 0xca,
+    0x27, 0x37, 0x07, 0x17, 0x67, 0x77, 0x47, 0x57, 0xa7, 0xb7, 0x87, 0x97, 0xe7, 0xf7, 0xc7, 0xd7,
+    0x74, 0x64, 0x54, 0x44, 0x34, 0x24, 0x14, 0x04, 0xf4, 0xe4, 0xd4, 0xc4, 0xb4, 0xa4, 0x94, 0x84,
+    0x69, 0x79, 0x49, 0x59, 0x29, 0x39, 0x09, 0x19, 0xe9, 0xf9, 0xc9, 0xd9, 0xa9, 0xb9, 0x89, 0x99,
+    0x4e, 0x5e, 0x6e, 0x7e, 0x0e, 0x1e, 0x2e, 0x3e, 0xce, 0xde, 0xee, 0xfe, 0x8e, 0x9e, 0xae, 0xbe,
+    0x53, 0x43, 0x73, 0x63, 0x13, 0x03, 0x33, 0x23, 0xd3, 0xc3, 0xf3, 0xe3, 0x93, 0x83, 0xb3, 0xa3,
+    0xe8, 0xf8, 0xc8, 0xd8, 0xa8, 0xb8, 0x88, 0x98, 0x68, 0x78, 0x48, 0x58, 0x28, 0x38, 0x08, 0x18,
+    0xf5, 0xe5, 0xd5, 0xc5, 0xb5, 0xa5, 0x95, 0x85, 0x75, 0x65, 0x55, 0x45, 0x35, 0x25, 0x15, 0x05,
+    0xd2, 0xc2, 0xf2, 0xe2, 0x92, 0x82, 0xb2, 0xa2, 0x52, 0x42, 0x72, 0x62, 0x12, 0x02, 0x32, 0x22,
+    0xcf, 0xdf, 0xef, 0xff, 0x8f, 0x9f, 0xaf, 0xbf, 0x4f, 0x5f, 0x6f, 0x7f, 0x0f, 0x1f, 0x2f, 0x3f,
+    0x9c, 0x8c, 0xbc, 0xac, 0xdc, 0xcc, 0xfc, 0xec, 0x1c, 0x0c, 0x3c, 0x2c, 0x5c, 0x4c, 0x7c, 0x6c,
+    0x81, 0x91, 0xa1, 0xb1, 0xc1, 0xd1, 0xe1, 0xf1, 0x01, 0x11, 0x21, 0x31, 0x41, 0x51, 0x61, 0x71,
+    0xa6, 0xb6, 0x86, 0x96, 0xe6, 0xf6, 0xc6, 0xd6, 0x26, 0x36, 0x06, 0x16, 0x66, 0x76, 0x46, 0x56,
+    0xbb, 0xab, 0x9b, 0x8b, 0xfb, 0xeb, 0xdb, 0xcb, 0x3b, 0x2b, 0x1b, 0x0b, 0x7b, 0x6b, 0x5b, 0x4b,
+    0x00, 0x20, 0x40, 0x60, 0x80, 0xa0, 0xc0, 0xe0, 0x1d, 0x3d, 0x5d, 0x7d, 0x9d, 0xbd, 0xdd, 0xfd,
+    0x3a, 0x1a, 0x7a, 0x5a, 0xba, 0x9a, 0xfa, 0xda, 0x27, 0x07, 0x67, 0x47, 0xa7, 0x87, 0xe7, 0xc7,
+    0x74, 0x54, 0x34, 0x14, 0xf4, 0xd4, 0xb4, 0x94, 0x69, 0x49, 0x29, 0x09, 0xe9, 0xc9, 0xa9, 0x89,
+    0x4e, 0x6e, 0x0e, 0x2e, 0xce, 0xee, 0x8e, 0xae, 0x53, 0x73, 0x13, 0x33, 0xd3, 0xf3, 0x93, 0xb3,
+    0xe8, 0xc8, 0xa8, 0x88, 0x68, 0x48, 0x28, 0x08, 0xf5, 0xd5, 0xb5, 0x95, 0x75, 0x55, 0x35, 0x15,
+    0xd2, 0xf2, 0x92, 0xb2, 0x52, 0x72, 0x12, 0x32, 0xcf, 0xef, 0x8f, 0xaf, 0x4f, 0x6f, 0x0f, 0x2f,
+    0x9c, 0xbc, 0xdc, 0xfc, 0x1c, 0x3c, 0x5c, 0x7c, 0x81, 0xa1, 0xc1, 0xe1, 0x01, 0x21, 0x41, 0x61,
+    0xa6, 0x86, 0xe6, 0xc6, 0x26, 0x06, 0x66, 0x46, 0xbb, 0x9b, 0xfb, 0xdb, 0x3b, 0x1b, 0x7b, 0x5b,
+    0xcd, 0xed, 0x8d, 0xad, 0x4d, 0x6d, 0x0d, 0x2d, 0xd0, 0xf0, 0x90, 0xb0, 0x50, 0x70, 0x10, 0x30,
+    0xf7, 0xd7, 0xb7, 0x97, 0x77, 0x57, 0x37, 0x17, 0xea, 0xca, 0xaa, 0x8a, 0x6a, 0x4a, 0x2a, 0x0a,
+    0xb9, 0x99, 0xf9, 0xd9, 0x39, 0x19, 0x79, 0x59, 0xa4, 0x84, 0xe4, 0xc4, 0x24, 0x04, 0x64, 0x44,
+    0x83, 0xa3, 0xc3, 0xe3, 0x03, 0x23, 0x43, 0x63, 0x9e, 0xbe, 0xde, 0xfe, 0x1e, 0x3e, 0x5e, 0x7e,
+    0x25, 0x05, 0x65, 0x45, 0xa5, 0x85, 0xe5, 0xc5, 0x38, 0x18, 0x78, 0x58, 0xb8, 0x98, 0xf8, 0xd8,
+    0x1f, 0x3f, 0x5f, 0x7f, 0x9f, 0xbf, 0xdf, 0xff, 0x02, 0x22, 0x42, 0x62, 0x82, 0xa2, 0xc2, 0xe2,
+    0x51, 0x71, 0x11, 0x31, 0xd1, 0xf1, 0x91, 0xb1, 0x4c, 0x6c, 0x0c, 0x2c, 0xcc, 0xec, 0x8c, 0xac,
+    0x6b, 0x4b, 0x2b, 0x0b, 0xeb, 0xcb, 0xab, 0x8b, 0x76, 0x56, 0x36, 0x16, 0xf6, 0xd6, 0xb6, 0x96,
+    0x00, 0x40, 0x80, 0xc0, 0x1d, 0x5d, 0x9d, 0xdd, 0x3a, 0x7a, 0xba, 0xfa, 0x27, 0x67, 0xa7, 0xe7,
+    0x74, 0x34, 0xf4, 0xb4, 0x69, 0x29, 0xe9, 0xa9, 0x4e, 0x0e, 0xce, 0x8e, 0x53, 0x13, 0xd3, 0x93,
+    0xe8, 0xa8, 0x68, 0x28, 0xf5, 0xb5, 0x75, 0x35, 0xd2, 0x92, 0x52, 0x12, 0xcf, 0x8f, 0x4f, 0x0f,
+    0x9c, 0xdc, 0x1c, 0x5c, 0x81, 0xc1, 0x01, 0x41, 0xa6, 0xe6, 0x26, 0x66, 0xbb, 0xfb, 0x3b, 0x7b,
+    0xcd, 0x8d, 0x4d, 0x0d, 0xd0, 0x90, 0x50, 0x10, 0xf7, 0xb7, 0x77, 0x37, 0xea, 0xaa, 0x6a, 0x2a,
+    0xb9, 0xf9, 0x39, 0x79, 0xa4, 0xe4, 0x24, 0x64, 0x83, 0xc3, 0x03, 0x43, 0x9e, 0xde, 0x1e, 0x5e,
+    0x25, 0x65, 0xa5, 0xe5, 0x38, 0x78, 0xb8, 0xf8, 0x1f, 0x5f, 0x9f, 0xdf, 0x02, 0x42, 0x82, 0xc2,
+    0x51, 0x11, 0xd1, 0x91, 0x4c, 0x0c, 0xcc, 0x8c, 0x6b, 0x2b, 0xeb, 0xab, 0x76, 0x36, 0xf6, 0xb6,
+    0x87, 0xc7, 0x07, 0x47, 0x9a, 0xda, 0x1a, 0x5a, 0xbd, 0xfd, 0x3d, 0x7d, 0xa0, 0xe0, 0x20, 0x60,
+    0xf3, 0xb3, 0x73, 0x33, 0xee, 0xae, 0x6e, 0x2e, 0xc9, 0x89, 0x49, 0x09, 0xd4, 0x94, 0x54, 0x14,
+    0x6f, 0x2f, 0xef, 0xaf, 0x72, 0x32, 0xf2, 0xb2, 0x55, 0x15, 0xd5, 0x95, 0x48, 0x08, 0xc8, 0x88,
+    0x1b, 0x5b, 0x9b, 0xdb, 0x06, 0x46, 0x86, 0xc6, 0x21, 0x61, 0xa1, 0xe1, 0x3c, 0x7c, 0xbc, 0xfc,
+    0x4a, 0x0a, 0xca, 0x8a, 0x57, 0x17, 0xd7, 0x97, 0x70, 0x30, 0xf0, 0xb0, 0x6d, 0x2d, 0xed, 0xad,
+    0x3e, 0x7e, 0xbe, 0xfe, 0x23, 0x63, 0xa3, 0xe3, 0x04, 0x44, 0x84, 0xc4, 0x19, 0x59, 0x99, 0xd9,
+    0xa2, 0xe2, 0x22, 0x62, 0xbf, 0xff, 0x3f, 0x7f, 0x98, 0xd8, 0x18, 0x58, 0x85, 0xc5, 0x05, 0x45,
+    0xd6, 0x96, 0x56, 0x16, 0xcb, 0x8b, 0x4b, 0x0b, 0xec, 0xac, 0x6c, 0x2c, 0xf1, 0xb1, 0x71, 0x31
+};
+
+// log(x^0) .. log(x^5) for every x, one row of 6 per element
+static const uint8_t element_exp_8_4_3_2_0_6[1536] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x01, 0x02, 0x03,
+    0x04, 0x05, 0xff, 0x19, 0x32, 0x4b, 0x64, 0x7d, 0xff, 0x02, 0x04, 0x06, 0x08, 0x0a, 0xff, 0x32,
+    0x64, 0x96, 0xc8, 0xfa, 0xff, 0x1a, 0x34, 0x4e, 0x68, 0x82, 0xff, 0xc6, 0x8d, 0x54, 0x1b, 0xe1,
+    0xff, 0x03, 0x06, 0x09, 0x0c, 0x0f, 0xff, 0xdf, 0xbf, 0x9f, 0x7f, 0x5f, 0xff, 0x33, 0x66, 0x99,
+    0xcc, 0xff, 0xff, 0xee, 0xdd, 0xcc, 0xbb, 0xaa, 0xff, 0x1b, 0x36, 0x51, 0x6c, 0x87, 0xff, 0x68,
+    0xd0, 0x39, 0xa1, 0x0a, 0xff, 0xc7, 0x8f, 0x57, 0x1f, 0xe6, 0xff, 0x4b, 0x96, 0xe1, 0x2d, 0x78,
+    0xff, 0x04, 0x08, 0x0c, 0x10, 0x14, 0xff, 0x64, 0xc8, 0x2d, 0x91, 0xf5, 0xff, 0xe0, 0xc1, 0xa2,
+    0x83, 0x64, 0xff, 0x0e, 0x1c, 0x2a, 0x38, 0x46, 0xff, 0x34, 0x68, 0x9c, 0xd0, 0x05, 0xff, 0x8d,
+    0x1b, 0xa8, 0x36, 0xc3, 0xff, 0xef, 0xdf, 0xcf, 0xbf, 0xaf, 0xff, 0x81, 0x03, 0x84, 0x06, 0x87,
+    0xff, 0x1c, 0x38, 0x54, 0x70, 0x8c, 0xff, 0xc1, 0x83, 0x45, 0x07, 0xc8, 0xff, 0x69, 0xd2, 0x3c,
+    0xa5, 0x0f, 0xff, 0xf8, 0xf1, 0xea, 0xe3, 0xdc, 0xff, 0xc8, 0x91, 0x5a, 0x23, 0xeb, 0xff, 0x08,
+    0x10, 0x18, 0x20, 0x28, 0xff, 0x4c, 0x98, 0xe4, 0x31, 0x7d, 0xff, 0x71, 0xe2, 0x54, 0xc5, 0x37,
+    0xff, 0x05, 0x0a, 0x0f, 0x14, 0x19, 0xff, 0x8a, 0x15, 0x9f, 0x2a, 0xb4, 0xff, 0x65, 0xca, 0x30,
+    0x95, 0xfa, 0xff, 0x2f, 0x5e, 0x8d, 0xbc, 0xeb, 0xff, 0xe1, 0xc3, 0xa5, 0x87, 0x69, 0xff, 0x24,
+    0x48, 0x6c, 0x90, 0xb4, 0xff, 0x0f, 0x1e, 0x2d, 0x3c, 0x4b, 0xff, 0x21, 0x42, 0x63, 0x84, 0xa5,
+    0xff, 0x35, 0x6a, 0x9f, 0xd4, 0x0a, 0xff, 0x93, 0x27, 0xba, 0x4e, 0xe1, 0xff, 0x8e, 0x1d, 0xab,
+    0x3a, 0xc8, 0xff, 0xda, 0xb5, 0x90, 0x6b, 0x46, 0xff, 0xf0, 0xe1, 0xd2, 0xc3, 0xb4, 0xff, 0x12,
+    0x24, 0x36, 0x48, 0x5a, 0xff, 0x82, 0x05, 0x87, 0x0a, 0x8c, 0xff, 0x45, 0x8a, 0xcf, 0x15, 0x5a,
+    0xff, 0x1d, 0x3a, 0x57, 0x74, 0x91, 0xff, 0xb5, 0x6b, 0x21, 0xd6, 0x8c, 0xff, 0xc2, 0x85, 0x48,
+    0x0b, 0xcd, 0xff, 0x7d, 0xfa, 0x78, 0xf5, 0x73, 0xff, 0x6a, 0xd4, 0x3f, 0xa9, 0x14, 0xff, 0x27,
+    0x4e, 0x75, 0x9c, 0xc3, 0xff, 0xf9, 0xf3, 0xed, 0xe7, 0xe1, 0xff, 0xb9, 0x73, 0x2d, 0xe6, 0xa0,
+    0xff, 0xc9, 0x93, 0x5d, 0x27, 0xf0, 0xff, 0x9a, 0x35, 0xcf, 0x6a, 0x05, 0xff, 0x09, 0x12, 0x1b,
+    0x24, 0x2d, 0xff, 0x78, 0xf0, 0x69, 0xe1, 0x5a, 0xff, 0x4d, 0x9a, 0xe7, 0x35, 0x82, 0xff, 0xe4,
+    0xc9, 0xae, 0x93, 0x78, 0xff, 0x72, 0xe4, 0x57, 0xc9, 0x3c, 0xff, 0xa6, 0x4d, 0xf3, 0x9a, 0x41,
+    0xff, 0x06, 0x0c, 0x12, 0x18, 0x1e, 0xff, 0xbf, 0x7f, 0x3f, 0xfe, 0xbe, 0xff, 0x8b, 0x17, 0xa2,
+    0x2e, 0xb9, 0xff, 0x62, 0xc4, 0x27, 0x89, 0xeb, 0xff, 0x66, 0xcc, 0x33, 0x99, 0xff, 0xff, 0xdd,
+    0xbb, 0x99, 0x77, 0x55, 0xff, 0x30, 0x60, 0x90, 0xc0, 0xf0, 0xff, 0xfd, 0xfb, 0xf9, 0xf7, 0xf5,
+    0xff, 0xe2, 0xc5, 0xa8, 0x8b, 0x6e, 0xff, 0x98, 0x31, 0xc9, 0x62, 0xfa, 0xff, 0x25, 0x4a, 0x6f,
+    0x94, 0xb9, 0xff, 0xb3, 0x67, 0x1b, 0xce, 0x82, 0xff, 0x10, 0x20, 0x30, 0x40, 0x50, 0xff, 0x91,
+    0x23, 0xb4, 0x46, 0xd7, 0xff, 0x22, 0x44, 0x66, 0x88, 0xaa, 0xff, 0x88, 0x11, 0x99, 0x22, 0xaa,
+    0xff, 0x36, 0x6c, 0xa2, 0xd8, 0x0f, 0xff, 0xd0, 0xa1, 0x72, 0x43, 0x14, 0xff, 0x94, 0x29, 0xbd,
+    0x52, 0xe6, 0xff, 0xce, 0x9d, 0x6c, 0x3b, 0x0a, 0xff, 0x8f, 0x1f, 0xae, 0x3e, 0xcd, 0xff, 0x96,
+    0x2d, 0xc3, 0x5a, 0xf0, 0xff, 0xdb, 0xb7, 0x93, 0x6f, 0x4b, 0xff, 0xbd, 0x7b, 0x39, 0xf6, 0xb4,
+    0xff, 0xf1, 0xe3, 0xd5, 0xc7, 0xb9, 0xff, 0xd2, 0xa5, 0x78, 0x4b, 0x1e, 0xff, 0x13, 0x26, 0x39,
+    0x4c, 0x5f, 0xff, 0x5c, 0xb8, 0x15, 0x71, 0xcd, 0xff, 0x83, 0x07, 0x8a, 0x0e, 0x91, 0xff, 0x38,
+    0x70, 0xa8, 0xe0, 0x19, 0xff, 0x46, 0x8c, 0xd2, 0x19, 0x5f, 0xff, 0x40, 0x80, 0xc0, 0x01, 0x41,
+    0xff, 0x1e, 0x3c, 0x5a, 0x78, 0x96, 0xff, 0x42, 0x84, 0xc6, 0x09, 0x4b, 0xff, 0xb6, 0x6d, 0x24,
+    0xda, 0x91, 0xff, 0xa3, 0x47, 0xea, 0x8e, 0x32, 0xff, 0xc3, 0x87, 0x4b, 0x0f, 0xd2, 0xff, 0x48,
+    0x90, 0xd8, 0x21, 0x69, 0xff, 0x7e, 0xfc, 0x7b, 0xf9, 0x78, 0xff, 0x6e, 0xdc, 0x4b, 0xb9, 0x28,
+    0xff, 0x6b, 0xd6, 0x42, 0xad, 0x19, 0xff, 0x3a, 0x74, 0xae, 0xe8, 0x23, 0xff, 0x28, 0x50, 0x78,
+    0xa0, 0xc8, 0xff, 0x54, 0xa8, 0xfc, 0x51, 0xa5, 0xff, 0xfa, 0xf5, 0xf0, 0xeb, 0xe6, 0xff, 0x85,
+    0x0b, 0x90, 0x16, 0x9b, 0xff, 0xba, 0x75, 0x30, 0xea, 0xa5, 0xff, 0x3d, 0x7a, 0xb7, 0xf4, 0x32,
+    0xff, 0xca, 0x95, 0x60, 0x2b, 0xf5, 0xff, 0x5e, 0xbc, 0x1b, 0x79, 0xd7, 0xff, 0x9b, 0x37, 0xd2,
+    0x6e, 0x0a, 0xff, 0x9f, 0x3f, 0xde, 0x7e, 0x1e, 0xff, 0x0a, 0x14, 0x1e, 0x28, 0x32, 0xff, 0x15,
+    0x2a, 0x3f, 0x54, 0x69, 0xff, 0x79, 0xf2, 0x6c, 0xe5, 0x5f, 0xff, 0x2b, 0x56, 0x81, 0xac, 0xd7,
+    0xff, 0x4e, 0x9c, 0xea, 0x39, 0x87, 0xff, 0xd4, 0xa9, 0x7e, 0x53, 0x28, 0xff, 0xe5, 0xcb, 0xb1,
+    0x97, 0x7d, 0xff, 0xac, 0x59, 0x06, 0xb2, 0x5f, 0xff, 0x73, 0xe6, 0x5a, 0xcd, 0x41, 0xff, 0xf3,
+    0xe7, 0xdb, 0xcf, 0xc3, 0xff, 0xa7, 0x4f, 0xf6, 0x9e, 0x46, 0xff, 0x57, 0xae, 0x06, 0x5d, 0xb4,
+    0xff, 0x07, 0x0e, 0x15, 0x1c, 0x23, 0xff, 0x70, 0xe0, 0x51, 0xc1, 0x32, 0xff, 0xc0, 0x81, 0x42,
+    0x03, 0xc3, 0xff, 0xf7, 0xef, 0xe7, 0xdf, 0xd7, 0xff, 0x8c, 0x19, 0xa5, 0x32, 0xbe, 0xff, 0x80,
+    0x01, 0x81, 0x02, 0x82, 0xff, 0x63, 0xc6, 0x2a, 0x8d, 0xf0, 0xff, 0x0d, 0x1a, 0x27, 0x34, 0x41,
+    0xff, 0x67, 0xce, 0x36, 0x9d, 0x05, 0xff, 0x4a, 0x94, 0xde, 0x29, 0x73, 0xff, 0xde, 0xbd, 0x9c,
+    0x7b, 0x5a, 0xff, 0xed, 0xdb, 0xc9, 0xb7, 0xa5, 0xff, 0x31, 0x62, 0x93, 0xc4, 0xf5, 0xff, 0xc5,
+    0x8b, 0x51, 0x17, 0xdc, 0xff, 0xfe, 0xfd, 0xfc, 0xfb, 0xfa, 0xff, 0x18, 0x30, 0x48, 0x60, 0x78,
+    0xff, 0xe3, 0xc7, 0xab, 0x8f, 0x73, 0xff, 0xa5, 0x4b, 0xf0, 0x96, 0x3c, 0xff, 0x99, 0x33, 0xcc,
+    0x66, 0xff, 0xff, 0x77, 0xee, 0x66, 0xdd, 0x55, 0xff, 0x26, 0x4c, 0x72, 0x98, 0xbe, 0xff, 0xb8,
+    0x71, 0x2a, 0xe2, 0x9b, 0xff, 0xb4, 0x69, 0x1e, 0xd2, 0x87, 0xff, 0x7c, 0xf8, 0x75, 0xf1, 0x6e,
+    0xff, 0x11, 0x22, 0x33, 0x44, 0x55, 0xff, 0x44, 0x88, 0xcc, 0x11, 0x55, 0xff, 0x92, 0x25, 0xb7,
+    0x4a, 0xdc, 0xff, 0xd9, 0xb3, 0x8d, 0x67, 0x41, 0xff, 0x23, 0x46, 0x69, 0x8c, 0xaf, 0xff, 0x20,
+    0x40, 0x60, 0x80, 0xa0, 0xff, 0x89, 0x13, 0x9c, 0x26, 0xaf, 0xff, 0x2e, 0x5c, 0x8a, 0xb8, 0xe6,
+    0xff, 0x37, 0x6e, 0xa5, 0xdc, 0x14, 0xff, 0x3f, 0x7e, 0xbd, 0xfc, 0x3c, 0xff, 0xd1, 0xa3, 0x75,
+    0x47, 0x19, 0xff, 0x5b, 0xb6, 0x12, 0x6d, 0xc8, 0xff, 0x95, 0x2b, 0xc0, 0x56, 0xeb, 0xff, 0xbc,
+    0x79, 0x36, 0xf2, 0xaf, 0xff, 0xcf, 0x9f, 0x6f, 0x3f, 0x0f, 0xff, 0xcd, 0x9b, 0x69, 0x37, 0x05,
+    0xff, 0x90, 0x21, 0xb1, 0x42, 0xd2, 0xff, 0x87, 0x0f, 0x96, 0x1e, 0xa5, 0xff, 0x97, 0x2f, 0xc6,
+    0x5e, 0xf5, 0xff, 0xb2, 0x65, 0x18, 0xca, 0x7d, 0xff, 0xdc, 0xb9, 0x96, 0x73, 0x50, 0xff, 0xfc,
+    0xf9, 0xf6, 0xf3, 0xf0, 0xff, 0xbe, 0x7d, 0x3c, 0xfa, 0xb9, 0xff, 0x61, 0xc2, 0x24, 0x85, 0xe6,
+    0xff, 0xf2, 0xe5, 0xd8, 0xcb, 0xbe, 0xff, 0x56, 0xac, 0x03, 0x59, 0xaf, 0xff, 0xd3, 0xa7, 0x7b,
+    0x4f, 0x23, 0xff, 0xab, 0x57, 0x03, 0xae, 0x5a, 0xff, 0x14, 0x28, 0x3c, 0x50, 0x64, 0xff, 0x2a,
+    0x54, 0x7e, 0xa8, 0xd2, 0xff, 0x5d, 0xba, 0x18, 0x75, 0xd2, 0xff, 0x9e, 0x3d, 0xdb, 0x7a, 0x19,
+    0xff, 0x84, 0x09, 0x8d, 0x12, 0x96, 0xff, 0x3c, 0x78, 0xb4, 0xf0, 0x2d, 0xff, 0x39, 0x72, 0xab,
+    0xe4, 0x1e, 0xff, 0x53, 0xa6, 0xf9, 0x4d, 0xa0, 0xff, 0x47, 0x8e, 0xd5, 0x1d, 0x64, 0xff, 0x6d,
+    0xda, 0x48, 0xb5, 0x23, 0xff, 0x41, 0x82, 0xc3, 0x05, 0x46, 0xff, 0xa2, 0x45, 0xe7, 0x8a, 0x2d,
+    0xff, 0x1f, 0x3e, 0x5d, 0x7c, 0x9b, 0xff, 0x2d, 0x5a, 0x87, 0xb4, 0xe1, 0xff, 0x43, 0x86, 0xc9,
+    0x0d, 0x50, 0xff, 0xd8, 0xb1, 0x8a, 0x63, 0x3c, 0xff, 0xb7, 0x6f, 0x27, 0xde, 0x96, 0xff, 0x7b,
+    0xf6, 0x72, 0xed, 0x69, 0xff, 0xa4, 0x49, 0xed, 0x92, 0x37, 0xff, 0x76, 0xec, 0x63, 0xd9, 0x50,
+    0xff, 0xc4, 0x89, 0x4e, 0x13, 0xd7, 0xff, 0x17, 0x2e, 0x45, 0x5c, 0x73, 0xff, 0x49, 0x92, 0xdb,
+    0x25, 0x6e, 0xff, 0xec, 0xd9, 0xc6, 0xb3, 0xa0, 0xff, 0x7f, 0xfe, 0x7e, 0xfd, 0x7d, 0xff, 0x0c,
+    0x18, 0x24, 0x30, 0x3c, 0xff, 0x6f, 0xde, 0x4e, 0xbd, 0x2d, 0xff, 0xf6, 0xed, 0xe4, 0xdb, 0xd2,
+    0xff, 0x6c, 0xd8, 0x45, 0xb1, 0x1e, 0xff, 0xa1, 0x43, 0xe4, 0x86, 0x28, 0xff, 0x3b, 0x76, 0xb1,
+    0xec, 0x28, 0xff, 0x52, 0xa4, 0xf6, 0x49, 0x9b, 0xff, 0x29, 0x52, 0x7b, 0xa4, 0xcd, 0xff, 0x9d,
+    0x3b, 0xd8, 0x76, 0x14, 0xff, 0x55, 0xaa, 0xff, 0x55, 0xaa, 0xff, 0xaa, 0x55, 0xff, 0xaa, 0x55,
+    0xff, 0xfb, 0xf7, 0xf3, 0xef, 0xeb, 0xff, 0x60, 0xc0, 0x21, 0x81, 0xe1, 0xff, 0x86, 0x0d, 0x93,
+    0x1a, 0xa0, 0xff, 0xb1, 0x63, 0x15, 0xc6, 0x78, 0xff, 0xbb, 0x77, 0x33, 0xee, 0xaa, 0xff, 0xcc,
+    0x99, 0x66, 0x33, 0xff, 0xff, 0x3e, 0x7c, 0xba, 0xf8, 0x37, 0xff, 0x5a, 0xb4, 0x0f, 0x69, 0xc3,
+    0xff, 0xcb, 0x97, 0x63, 0x2f, 0xfa, 0xff, 0x59, 0xb2, 0x0c, 0x65, 0xbe, 0xff, 0x5f, 0xbe, 0x1e,
+    0x7d, 0xdc, 0xff, 0xb0, 0x61, 0x12, 0xc2, 0x73, 0xff, 0x9c, 0x39, 0xd5, 0x72, 0x0f, 0xff, 0xa9,
+    0x53, 0xfc, 0xa6, 0x50, 0xff, 0xa0, 0x41, 0xe1, 0x82, 0x23, 0xff, 0x51, 0xa2, 0xf3, 0x45, 0x96,
+    0xff, 0x0b, 0x16, 0x21, 0x2c, 0x37, 0xff, 0xf5, 0xeb, 0xe1, 0xd7, 0xcd, 0xff, 0x16, 0x2c, 0x42,
+    0x58, 0x6e, 0xff, 0xeb, 0xd7, 0xc3, 0xaf, 0x9b, 0xff, 0x7a, 0xf4, 0x6f, 0xe9, 0x64, 0xff, 0x75,
+    0xea, 0x60, 0xd5, 0x4b, 0xff, 0x2c, 0x58, 0x84, 0xb0, 0xdc, 0xff, 0xd7, 0xaf, 0x87, 0x5f, 0x37,
+    0xff, 0x4f, 0x9e, 0xed, 0x3d, 0x8c, 0xff, 0xae, 0x5d, 0x0c, 0xba, 0x69, 0xff, 0xd5, 0xab, 0x81,
+    0x57, 0x2d, 0xff, 0xe9, 0xd3, 0xbd, 0xa7, 0x91, 0xff, 0xe6, 0xcd, 0xb4, 0x9b, 0x82, 0xff, 0xe7,
+    0xcf, 0xb7, 0x9f, 0x87, 0xff, 0xad, 0x5b, 0x09, 0xb6, 0x64, 0xff, 0xe8, 0xd1, 0xba, 0xa3, 0x8c,
+    0xff, 0x74, 0xe8, 0x5d, 0xd1, 0x46, 0xff, 0xd6, 0xad, 0x84, 0x5b, 0x32, 0xff, 0xf4, 0xe9, 0xde,
+    0xd3, 0xc8, 0xff, 0xea, 0xd5, 0xc0, 0xab, 0x96, 0xff, 0xa8, 0x51, 0xf9, 0xa2, 0x4b, 0xff, 0x50,
+    0xa0, 0xf0, 0x41, 0x91, 0xff, 0x58, 0xb0, 0x09, 0x61, 0xb9, 0xff, 0xaf, 0x5f, 0x0f, 0xbe, 0x6e
+};
+
+const correct_reed_solomon_tables correct_rs_tables_8_4_3_2_0_6 = {
+    .primitive_polynomial = 0x11d,
+    .first_consecutive_root = 1,
+    .generator_root_gap = 1,
+    .num_roots = 6,
+    .exp = exp_8_4_3_2_0,
+    .log = log_8_4_3_2_0,
+    .generator_root_mul = generator_root_mul_8_4_3_2_0_6,
+    .element_exp = element_exp_8_4_3_2_0_6,
+};
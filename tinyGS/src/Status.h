@@ -25,11 +25,12 @@
 #define Status_h
 
 struct PacketInfo {
-  String time = "Waiting";
+  char time[10] = "Waiting";   // hh:mm:ss
   float rssi = 0;
   float snr = 0;
   float frequencyerror = 0;    // Hz 
   bool crc_error = false;
+  int16_t rs_corrected = 0;    // symbols repaired by the RS stage, -1 uncorrectable
 };
 
 struct ModemInfo {
@@ -53,6 +54,51 @@ struct ModemInfo {
   uint8_t   fsw[8]    = {0,0,0,0,0,0,0,0};
   uint8_t   swSize     = 0;
   uint8_t   filter[8] = {0,0,0,0,0,0,0,0};
+  bool      rsCcsds   = false;  // RS(255,223) CCSDS instead of the shortened code
+  uint8_t   rsParity  = 6;      // RS parity bytes (32 with CCSDS), 0 disables the RS stage
+  bool      conv      = false;  // frames carry the r=1/2 K=7 convolutional code
+  uint8_t   interleaverDepth = 4; // 4x4, 8x8 or 16x16 interleaver blocks
+  bool      lengthHeader = false; // codeword length header instead of the 0xFF end marker
+};
+
+struct FecStats {
+  uint32_t rsClean = 0;       // frames whose syndromes were all zero
+  uint32_t rsCorrected = 0;   // frames repaired by the full RS decoder
+  uint32_t rsFailed = 0;      // uncorrectable frames
+  uint32_t rxCycles = 0;      // CPU cycles of the last RX pipeline run
+  uint32_t rxCyclesMax = 0;
+};
+
+struct RxQueueStats {
+  uint32_t poolExhausted = 0; // frames lost because every pooled buffer was still in use
+  uint32_t reportsDropped = 0; // decoded frames lost because the main loop fell behind
+  uint8_t depthMax = 0;       // peak frames waiting in the RX ring
+  uint8_t reportDepthMax = 0; // peak decoded frames waiting for the main loop
+  uint32_t latency = 0;       // ms from draining the radio to the main loop taking the frame
+  uint32_t latencyMax = 0;
+};
+
+struct JournalStats {
+  uint32_t stored = 0;        // frames written to flash while MQTT was down
+  uint32_t replayed = 0;      // frames published from flash after reconnecting
+  uint32_t pending = 0;       // frames still waiting in flash
+  uint32_t lost = 0;          // frames overwritten before replay or found corrupted
+};
+
+// A pooled receive buffer, the radio FIFO is read straight into data and the
+// frame is decoded in place, then published and returned to the pool
+struct RxFrame {
+  size_t length;
+  int16_t state;              // RadioLib result of the read
+  float rssi;
+  float snr;
+  float frequencyerror;
+  bool noisy;                 // interrupts were missed before this frame
+  int64_t irqTime;            // esp_timer_get_time() when the DIO interrupt fired
+  int64_t irqUnixUsec;        // the same instant on the NTP disciplined clock, us since epoch
+  bool crc_error;
+  int16_t rs_corrected;
+  uint8_t data[256];
 };
 
 struct TextFrame {   
@@ -70,6 +116,9 @@ struct Status {
   bool radio_ready = false;
   PacketInfo lastPacketInfo;
   ModemInfo modeminfo;
+  FecStats fecStats;
+  RxQueueStats rxQueue;
+  JournalStats journal;
   float satPos[2] = {0, 0};
   uint8_t remoteTextFrameLength[4] = {0, 0, 0, 0};
   TextFrame remoteTextFrame[4][15];
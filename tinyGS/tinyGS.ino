@@ -74,6 +74,10 @@
 #include "src/Mqtt/MQTT_Client.h"
 #include "src/Status.h"
 #include "src/Radio/Radio.h"
+#include "src/Radio/Telecommands.h"
+#include "src/Radio/DataSession.h"
+#include "src/Orbit/Orbit.h"
+#include "src/Radio/Doppler.h"
 #include "src/ArduinoOTA/ArduinoOTA.h"
 #include "src/OTA/OTA.h"
 #include <ESPNtpClient.h>
@@ -103,6 +107,13 @@ void printControls();
 void switchTestmode();
 void checkButton();
 void setupNTP();
+void startNetworkTask();
+void networkTask(void* param);
+void networkLoop();
+
+static const uint32_t NETWORK_TASK_STACK = 8192;     // same as the Arduino loop task
+static const UBaseType_t NETWORK_TASK_PRIORITY = 1;  // same as the Arduino loop task
+static const BaseType_t NETWORK_CORE = 0;            // PRO_CPU, with the WiFi driver and lwIP
 
 void ntp_cb (NTPEvent_t e)
 {
@@ -156,6 +167,7 @@ void setup()
     configManager.setConfiguredCallback(NULL);
     configManager.setWifiConnectionCallback(NULL);
     Log::console(PSTR("FATAL ERROR: The board is in a boot loop, rescue mode launched. Connect to the WiFi AP: %s, and open a web browser on ip 192.168.4.1 to fix your configuration problem or upload a new firmware."), configManager.getThingName());
+    startNetworkTask();
     return;
   }
   // make sure to call doLoop at least once before starting to use the configManager
@@ -165,6 +177,7 @@ void setup()
   displayShowInitialCredits();
   configManager.delay(1000);
   mqtt.begin();
+  Orbit::getInstance().begin();
 
   if (configManager.getOledBright() == 0)
   {
@@ -172,9 +185,31 @@ void setup()
   }
   
   printControls();
+  startNetworkTask();
+}
+
+// The web panel, MQTT, OTA and the consoles run in their own task on core 0,
+// next to the WiFi driver and lwIP, the radio tasks have core 1 to themselves
+void startNetworkTask()
+{
+  xTaskCreatePinnedToCore(networkTask, "network", NETWORK_TASK_STACK, nullptr, NETWORK_TASK_PRIORITY, nullptr, NETWORK_CORE);
+}
+
+void networkTask(void* param)
+{
+  for (;;)
+  {
+    networkLoop();
+    vTaskDelay(1); // the idle task of core 0 feeds the task watchdog
+  }
 }
 
-void loop() {  
+void loop() {
+  // everything runs in the network task, the Arduino loop task is not needed
+  vTaskDelete(NULL);
+}
+
+void networkLoop() {
   configManager.doLoop();
   if (configManager.isFailSafeActive())
   {
@@ -204,7 +239,15 @@ void loop() {
   if (radio.isReady())
   {
     status.radio_ready = true;
-    radio.listen();
+    // frames are received and decoded by the radio tasks, here they are only published
+    while (RxFrame* frame = radio.takeFrame())
+    {
+      mqtt.sendRx(*frame);
+      radio.releaseFrame(frame);
+    }
+    DataSession::getInstance().loop();
+    Orbit::getInstance().loop();
+    Doppler::getInstance().loop();
   }
   else {
     status.radio_ready = false;
@@ -276,20 +319,25 @@ void handleSerial()
   {
     radio.disableInterrupt();
 
-    // get the first character
-    char serialCmd = Serial.read();
+    // get the command, one or two characters
+    char serialCmd[8];
+    size_t cmdLen = 0;
+    serialCmd[cmdLen++] = Serial.read();
 
     // wait for a bit to receive any trailing characters
     configManager.delay(50);
 
-    // dump the serial buffer
+    // keep the rest of the line, dump the serial buffer
     while(Serial.available())
     {
-      Serial.read();
+      char c = Serial.read();
+      if (c != '\r' && c != '\n' && cmdLen < sizeof(serialCmd) - 1)
+        serialCmd[cmdLen++] = c;
     }
+    serialCmd[cmdLen] = '\0';
 
     // process serial command
-    switch(serialCmd) {
+    switch(cmdLen == 1 ? serialCmd[0] : 0) {
       case 'e':
         configManager.resetAllConfig();
         ESP.restart();
@@ -318,134 +366,9 @@ void handleSerial()
         lastTestPacketTime = millis();
         Log::console(PSTR("Sending test packet to nearby stations!"));
         break;
-      case '1':
-        configManager.txTC(radio.RESET_TC," RESET", sizeof(radio.RESET_TC));
-        break;
-      case '2':
-        configManager.txTC(radio.EXIT_STATE_TC,"EXIT STATE", sizeof(radio.EXIT_STATE_TC));
-        break;
-      case '10':
-        if (!configManager.getAllowTx())
-        {
-          Log::console(PSTR("Radio transmission is not allowed by config! Check your config on the web panel and make sure transmission is allowed by local regulations"));
-        }
-        else
-        {
-          lastTestPacketTime = 0;
-          if (millis() - lastTestPacketTime < 20*1000)
-          {
-            Log::console(PSTR("Please wait a few seconds to send another test packet."));
-          }
-          else
-          {
-          size_t newArraySize = sizeof(radio.TLE_TC_1) + 4;
-          uint8_t concatenatedArray[newArraySize];
-          configManager.concatenate_unix(radio.TLE_TC_1, newArraySize,concatenatedArray);
-          uint8_t telecomand_encoded[256];
-          int size = configManager.encode(concatenatedArray,  newArraySize, telecomand_encoded);
-          
-          size_t newArraySize2 = sizeof(radio.TLE_TC_2) + 4;
-          uint8_t concatenatedArray2[newArraySize2];
-          configManager.concatenate_unix(radio.TLE_TC_2, newArraySize2,concatenatedArray2);
-          uint8_t telecomand_encoded2[256];
-          int size2 = configManager.encode(concatenatedArray2,  newArraySize2, telecomand_encoded2);
-          
-          size_t newArraySize3 = sizeof(radio.TLE_TC_3) + 4;
-          uint8_t concatenatedArray3[newArraySize3];
-          configManager.concatenate_unix(radio.TLE_TC_3, newArraySize3,concatenatedArray3);
-          uint8_t telecomand_encoded3[256];
-          int size3 = configManager.encode(concatenatedArray3,  newArraySize3, telecomand_encoded3);
-                    
-          size_t newArraySize4 = sizeof(radio.TLE_TC_4) + 4;
-          uint8_t concatenatedArray4[newArraySize4];
-          configManager.concatenate_unix(radio.TLE_TC_4, newArraySize4,concatenatedArray4);
-          uint8_t telecomand_encoded4[256];
-          int size4 = configManager.encode(concatenatedArray4,  newArraySize4, telecomand_encoded4);
-                    
-          size_t newArraySize5 = sizeof(radio.TLE_TC_5) + 4;
-          uint8_t concatenatedArray5[newArraySize5];
-          configManager.concatenate_unix(radio.TLE_TC_5, newArraySize5,concatenatedArray5);
-          uint8_t telecomand_encoded5[256];
-          int size5 = configManager.encode(concatenatedArray5,  newArraySize5, telecomand_encoded5);
-
-
-            radio.sendTx(telecomand_encoded, size);
-            delay(200);
-            //radio.sendTx(radio.TLE_TC_2, sizeof(radio.TLE_TC_2));
-            radio.sendTx(telecomand_encoded2, size2);
-            delay(200);
-            radio.sendTx(telecomand_encoded3, size3);
-            delay(200);
-            radio.sendTx(telecomand_encoded4, size4);
-            delay(200);
-            radio.sendTx(telecomand_encoded5, size5);
-            lastTestPacketTime = millis();
-            Log::console(PSTR("Sending TLE packets!"));
-          }
-        }
-        break;
-      case '11':
-        if (!configManager.getAllowTx())
-        {
-          Log::console(PSTR("Radio transmission is not allowed by config! Check your config on the web panel and make sure transmission is allowed by local regulations"));
-        }
-        else
-        {
-          lastTestPacketTime = 0;
-          if (millis() - lastTestPacketTime < 20*1000)
-          {
-            Log::console(PSTR("Please wait a few seconds to send another test packet."));
-          }
-          else
-          {
-            uint8_t concatenatedArray[sizeof(radio.ADCS_CALIBRATION_TC_1) ];
-            configManager.concatenate_unix(radio.ADCS_CALIBRATION_TC_1, sizeof(radio.ADCS_CALIBRATION_TC_1) ,concatenatedArray);
-            uint8_t telecomand_encoded[256];
-            int size = configManager.encode(concatenatedArray,  sizeof(radio.ADCS_CALIBRATION_TC_1) , telecomand_encoded);
-            
-            uint8_t concatenatedArray2[sizeof(radio.ADCS_CALIBRATION_TC_2) ];
-            configManager.concatenate_unix(radio.ADCS_CALIBRATION_TC_2, sizeof(radio.ADCS_CALIBRATION_TC_2),concatenatedArray2);
-            uint8_t telecomand_encoded2[256];
-            int size2 = configManager.encode(concatenatedArray2,  sizeof(radio.ADCS_CALIBRATION_TC_2), telecomand_encoded2);
-            
-            uint8_t concatenatedArray3[sizeof(radio.ADCS_CALIBRATION_TC_3) ];
-            configManager.concatenate_unix(radio.ADCS_CALIBRATION_TC_3, sizeof(radio.ADCS_CALIBRATION_TC_3) ,concatenatedArray3);
-            uint8_t telecomand_encoded3[256];
-            int size3 = configManager.encode(concatenatedArray3,  sizeof(radio.ADCS_CALIBRATION_TC_3) , telecomand_encoded3);
-
-            radio.sendTx(telecomand_encoded, size);
-            delay(500);
-            radio.sendTx(telecomand_encoded2, size2);
-            delay(500);
-            radio.sendTx(telecomand_encoded3, size3);
-            lastTestPacketTime = millis();
-            Log::console(PSTR("Sending ADCS_CALIBRATION packets!"));
-          }
-        }
-        break;
-      case '20':
-        configManager.txTC(radio.SEND_DATA_TC,"SEND DATA", sizeof(radio.SEND_DATA_TC));
-        break;
-      case '21':
-        configManager.txTC(radio.SEND_TELEMETRY_TC,"SEND TELEMETRY", sizeof(radio.SEND_TELEMETRY_TC));
-        break;
-      case '22':
-        configManager.txTC(radio.STOP_SENDING_DATA_TC,"STOP SENDING DATA", sizeof(radio.STOP_SENDING_DATA_TC));
-        break;
-      case '23':
-        configManager.txTC(radio.CHANGE_TIMEOUT_TC,"CHANGE TIMEOUT", sizeof(radio.CHANGE_TIMEOUT_TC));
-        break;
-      case '30':
-        configManager.txTC(radio.ACTIVATE_PAYLOAD_TC,"ACTIVATE_PAYLOAD", sizeof(radio.ACTIVATE_PAYLOAD_TC));
-        break;
-      case '40':
-        configManager.txTC(radio.SEND_CONFIG_TC, "SEND CONFIG", sizeof(radio.SEND_CONFIG_TC));
-        break;
-      case '41':
-        configManager.txTC(radio.UPLINK_CONFIG_TC,"UPLINK CONFIG", sizeof(radio.UPLINK_CONFIG_TC));
-        break;
       default:
-        Log::console(PSTR("Unknown command: %c"), serialCmd);
+        if (!Telecommands::getInstance().command(serialCmd))
+          Log::console(PSTR("Unknown command: %s"), serialCmd);
         break;
     }
 